@@ -35,6 +35,7 @@
 #include <json/json.h>
 
 #include <cdogs/campaign_entry.h>
+#include <cdogs/file_writer.h>
 #include <cdogs/json_utils.h>
 #include <cdogs/utils.h>
 #include <cdogs/sys_specifics.h>
@@ -166,32 +167,14 @@ bail:
 
 void AutosaveSave(Autosave *autosave, const char *filename)
 {
-	FILE *f = fopen(filename, "w");
-	char *text = NULL;
-	json_t *root;
-	
-	if (f == NULL)
-	{
-		printf("Error saving autosave '%s'\n", filename);
-		return;
-	}
-	
-	root = json_new_object();
+	json_t *root = json_new_object();
 	json_insert_pair_into_object(root, "Version", json_new_number("2"));
 	json_insert_pair_into_object(
 		root, "LastMission", CreateMissionNode(&autosave->LastMission));
 	AddMissionNodes(autosave, root, "Missions");
 
-	json_tree_to_string(root, &text);
-	char *formatText = json_format_string(text);
-	fputs(formatText, f);
-	
-	// clean up
-	free(formatText);
-	free(text);
-	json_free_value(&root);
-	
-	fclose(f);
+	// The tree is a snapshot; serialise and write it in the background
+	FileWriterSaveJSON(&gFileWriter, filename, root);
 }
 
 MissionSave *AutosaveFindMission(Autosave *autosave, const char *path)
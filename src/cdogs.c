@@ -57,13 +57,17 @@
 #undef main
 #endif
 
+#include <cdogs/ai_coop.h>
+#include <cdogs/ai_index.h>
 #include <cdogs/ammo.h>
 #include <cdogs/campaigns.h>
 #include <cdogs/character_class.h>
 #include <cdogs/collision/collision.h>
 #include <cdogs/config_io.h>
+#include <cdogs/draw/actor_pic_cache.h>
 #include <cdogs/draw/char_sprites.h>
 #include <cdogs/draw/draw.h>
+#include <cdogs/file_writer.h>
 #include <cdogs/files.h>
 #include <cdogs/font_utils.h>
 #include <cdogs/grafx.h>
@@ -85,6 +89,7 @@
 #include <cdogs/player_template.h>
 #include <cdogs/sounds.h>
 #include <cdogs/SDL_JoystickButtonNames/SDL_joystickbuttonnames.h>
+#include <cdogs/thread_pool.h>
 #include <cdogs/triggers.h>
 #include <cdogs/utils.h>
 
@@ -200,6 +205,9 @@ int main(int argc, char *argv[])
 		goto bail;
 	}
 	SDL_EventState(SDL_DROPFILE, SDL_DISABLE);
+	ThreadPoolInit(&gThreadPool, -1);
+	FileWriterInit(&gFileWriter);
+	AIIndexInit(&gAIIndex);
 
 	GetDataFilePath(buf, "");
 	LOG(LM_MAIN, LL_INFO, "data dir(%s)", buf);
@@ -221,6 +229,7 @@ int main(int argc, char *argv[])
 	EventInit(&gEventHandlers, NULL, NULL, true);
 	NetServerInit(&gNetServer);
 	PicManagerInit(&gPicManager);
+	ActorPicCacheInit(&gActorPicCache, ACTOR_PIC_CACHE_MEMORY);
 	GraphicsInit(&gGraphicsDevice, &gConfig);
 	GraphicsInitialize(&gGraphicsDevice);
 	if (!gGraphicsDevice.IsInitialized)
@@ -306,6 +315,7 @@ bail:
 	CollisionSystemTerminate(&gCollisionSystem);
 
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
+	ActorPicCacheTerminate(&gActorPicCache);
 	PicManagerTerminate(&gPicManager);
 	FontTerminate(&gFont);
 	AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
@@ -318,6 +328,10 @@ bail:
 	UnloadAllCampaigns(&campaigns);
 	SoundTerminate(&gSoundDevice, true);
 	ConfigDestroy(&gConfig);
+	AIIndexTerminate(&gAIIndex);
+	AICoopTerminate();
+	FileWriterTerminate(&gFileWriter);
+	ThreadPoolTerminate(&gThreadPool);
 	LogTerminate();
 
 	SDLJBN_Quit();
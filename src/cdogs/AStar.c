@@ -64,7 +64,7 @@ typedef struct {
     int8_t nodeKey[1];
 } NodeRecord;
 
-struct __VisitedNodes {
+struct __ASPathContext {
     const ASPathNodeSource *source;
     void *context;
     size_t nodeRecordsCapacity;
@@ -74,8 +74,14 @@ struct __VisitedNodes {
     size_t openNodesCapacity;
     size_t openNodesCount;
     size_t *openNodes;                  // binary heap of nodeRecords indexes, sorted by the nodeRecords[i]->rank
+    // dense lookup, used instead of nodeRecordsIndex if source->nodeIndex is set
+    size_t maxNodes;
+    size_t *denseRecords;               // nodeRecords index for each node index
+    unsigned *denseGenerations;         // denseRecords entries are only valid if they match the current generation
+    unsigned generation;
+    ASNeighborList neighborList;
 };
-typedef struct __VisitedNodes *VisitedNodes;
+typedef struct __ASPathContext *VisitedNodes;
 
 typedef struct {
     VisitedNodes nodes;
@@ -86,12 +92,20 @@ static const Node NodeNull = {NULL, -1};
 
 /********************************************/
 
-static inline VisitedNodes VisitedNodesCreate(const ASPathNodeSource *source, void *context)
+static inline ASNeighborList NeighborListCreate(const ASPathNodeSource *source);
+static inline void NeighborListDestroy(ASNeighborList list);
+
+static inline VisitedNodes VisitedNodesCreate(const ASPathNodeSource *source, size_t maxNodes)
 {
 	VisitedNodes nodes;
-	CCALLOC(nodes, sizeof(struct __VisitedNodes));
+	CCALLOC(nodes, sizeof(struct __ASPathContext));
     nodes->source = source;
-    nodes->context = context;
+    if (source->nodeIndex && maxNodes > 0) {
+        nodes->maxNodes = maxNodes;
+        CMALLOC(nodes->denseRecords, maxNodes * sizeof(size_t));
+        CCALLOC(nodes->denseGenerations, maxNodes * sizeof(unsigned));
+    }
+    nodes->neighborList = NeighborListCreate(source);
     return nodes;
 }
 
@@ -100,9 +114,28 @@ static inline void VisitedNodesDestroy(VisitedNodes visitedNodes)
     CFREE(visitedNodes->nodeRecordsIndex);
 	CFREE(visitedNodes->nodeRecords);
 	CFREE(visitedNodes->openNodes);
+	CFREE(visitedNodes->denseRecords);
+	CFREE(visitedNodes->denseGenerations);
+	NeighborListDestroy(visitedNodes->neighborList);
 	CFREE(visitedNodes);
 }
 
+// Forget the previous search, keeping the buffers
+static inline void VisitedNodesReset(VisitedNodes nodes, void *context)
+{
+    nodes->context = context;
+    nodes->nodeRecordsCount = 0;
+    nodes->openNodesCount = 0;
+    nodes->generation++;
+    if (nodes->generation == 0) {
+        // wrapped around; old generations could look current
+        if (nodes->denseGenerations) {
+            memset(nodes->denseGenerations, 0, nodes->maxNodes * sizeof(unsigned));
+        }
+        nodes->generation = 1;
+    }
+}
+
 static inline int NodeIsNull(Node n)
 {
     return (n.nodes == NodeNull.nodes) && (n.index == NodeNull.index);
@@ -223,14 +256,49 @@ static inline int NodeKeyCompare(Node node, void *nodeKey)
     }
 }
 
+static Node AddNodeRecord(VisitedNodes nodes, void *nodeKey)
+{
+    Node node;
+    NodeRecord *record;
+    if (nodes->nodeRecordsCount == nodes->nodeRecordsCapacity) {
+        nodes->nodeRecordsCapacity = 1 + (nodes->nodeRecordsCapacity * 2);
+        CREALLOC(nodes->nodeRecords, nodes->nodeRecordsCapacity * (sizeof(NodeRecord) + nodes->source->nodeSize));
+        if (!nodes->denseRecords) {
+            CREALLOC(nodes->nodeRecordsIndex, nodes->nodeRecordsCapacity * sizeof(size_t));
+        }
+    }
+
+    node = NodeMake(nodes, nodes->nodeRecordsCount);
+    nodes->nodeRecordsCount++;
+
+    record = NodeGetRecord(node);
+    memset(record, 0, sizeof(NodeRecord));
+    memcpy(record->nodeKey, nodeKey, nodes->source->nodeSize);
+    return node;
+}
+
 static Node GetNode(VisitedNodes nodes, void *nodeKey)
 {
     size_t first;
     Node node;
-    NodeRecord *record;
     if (!nodeKey) {
         return NodeNull;
     }
+
+    if (nodes->denseRecords) {
+        // look it up directly by its index, adding a new record if it hasn't been visited in this search
+        const size_t idx = nodes->source->nodeIndex(nodeKey, nodes->context);
+        if (idx >= nodes->maxNodes) {
+            return NodeNull;
+        }
+        if (nodes->denseGenerations[idx] == nodes->generation) {
+            return NodeMake(nodes, nodes->denseRecords[idx]);
+        }
+        node = AddNodeRecord(nodes, nodeKey);
+        nodes->denseRecords[idx] = node.index;
+        nodes->denseGenerations[idx] = nodes->generation;
+        return node;
+    }
     
     // looks it up in the index, if it's not found it inserts a new record in the sorted index and the nodeRecords array and returns a reference to it
     first = 0;
@@ -254,21 +322,11 @@ static Node GetNode(VisitedNodes nodes, void *nodeKey)
         }
     }
     
-    if (nodes->nodeRecordsCount == nodes->nodeRecordsCapacity) {
-        nodes->nodeRecordsCapacity = 1 + (nodes->nodeRecordsCapacity * 2);
-        CREALLOC(nodes->nodeRecords, nodes->nodeRecordsCapacity * (sizeof(NodeRecord) + nodes->source->nodeSize));
-		CREALLOC(nodes->nodeRecordsIndex, nodes->nodeRecordsCapacity * sizeof(size_t));
-    }
-    
-    node = NodeMake(nodes, nodes->nodeRecordsCount);
-    nodes->nodeRecordsCount++;
-    
-    memmove(&nodes->nodeRecordsIndex[first+1], &nodes->nodeRecordsIndex[first], (nodes->nodeRecordsCapacity - first - 1) * sizeof(size_t));
+    node = AddNodeRecord(nodes, nodeKey);
+
+    // only the used part of the index needs to be moved
+    memmove(&nodes->nodeRecordsIndex[first+1], &nodes->nodeRecordsIndex[first], (nodes->nodeRecordsCount - first - 1) * sizeof(size_t));
     nodes->nodeRecordsIndex[first] = node.index;
-    
-    record = NodeGetRecord(node);
-    memset(record, 0, sizeof(NodeRecord));
-    memcpy(record->nodeKey, nodeKey, nodes->source->nodeSize);
 
     return node;
 }
@@ -335,7 +393,7 @@ static inline void DidInsertIntoOpenSetAtIndex(VisitedNodes nodes, size_t idx)
 {
     while (idx > 0)
     {
-        const size_t parentIndex = (size_t)floorf((float)(idx-1) / 2);
+        const size_t parentIndex = (idx - 1) / 2;
         
         if (NodeRankCompare(NodeMake(nodes, nodes->openNodes[parentIndex]), NodeMake(nodes, nodes->openNodes[idx])) < 0)
 	{
@@ -425,21 +483,49 @@ void ASNeighborListAdd(ASNeighborList list, void *node, float edgeCost)
     list->count++;
 }
 
+ASPathContext ASPathContextCreate(const ASPathNodeSource *source, size_t maxNodes)
+{
+    if (!source || !source->nodeNeighbors || source->nodeSize == 0) {
+        return NULL;
+    }
+    return VisitedNodesCreate(source, maxNodes);
+}
+
+void ASPathContextDestroy(ASPathContext pathContext)
+{
+    if (pathContext) {
+        VisitedNodesDestroy(pathContext);
+    }
+}
+
 ASPath ASPathCreate(const ASPathNodeSource *source, void *context, void *startNodeKey, void *goalNodeKey)
 {
-    VisitedNodes visitedNodes;
+    ASPathContext pathContext = ASPathContextCreate(source, 0);
+    ASPath path = ASPathContextCreatePath(pathContext, context, startNodeKey, goalNodeKey);
+    ASPathContextDestroy(pathContext);
+    return path;
+}
+
+ASPath ASPathContextCreatePath(ASPathContext pathContext, void *context, void *startNodeKey, void *goalNodeKey)
+{
+    VisitedNodes visitedNodes = pathContext;
+    const ASPathNodeSource *source;
     ASNeighborList neighborList;
     Node current;
     Node goalNode;
     ASPath path = NULL;
-    if (!startNodeKey || !source || !source->nodeNeighbors || source->nodeSize == 0) {
+    if (!startNodeKey || !pathContext) {
         return NULL;
     }
-    
-    visitedNodes = VisitedNodesCreate(source, context);
-    neighborList = NeighborListCreate(source);
+
+    VisitedNodesReset(visitedNodes, context);
+    source = visitedNodes->source;
+    neighborList = visitedNodes->neighborList;
     current = GetNode(visitedNodes, startNodeKey);
     goalNode = GetNode(visitedNodes, goalNodeKey);
+    if (NodeIsNull(current)) {
+        return NULL;
+    }
  
     // mark the goal node as the goal
     SetNodeIsGoal(goalNode);
@@ -471,7 +557,10 @@ ASPath ASPathCreate(const ASPathNodeSource *source, void *context, void *startNo
         for (n=0; n<neighborList->count; n++) {
             const float cost = GetNodeCost(current) + NeighborListGetEdgeCost(neighborList, n);
             Node neighbor = GetNode(visitedNodes, NeighborListGetNodeKey(neighborList, n));
-            
+            if (NodeIsNull(neighbor)) {
+                continue;
+            }
+
             if (!NodeHasEstimatedCost(neighbor)) {
                 SetNodeEstimatedCost(neighbor, GetPathCostHeuristic(neighbor, goalNode));
             }
@@ -516,9 +605,6 @@ ASPath ASPathCreate(const ASPathNodeSource *source, void *context, void *startNo
         }
     }
     
-    NeighborListDestroy(neighborList);
-    VisitedNodesDestroy(visitedNodes);
-
     return path;
 }
 
@@ -540,6 +626,22 @@ ASPath ASPathCopy(ASPath path)
     }
 }
 
+ASPath ASPathCopyFrom(ASPath path, size_t idx)
+{
+    if (path && idx < path->count) {
+        const size_t count = path->count - idx;
+        ASPath newPath;
+        CMALLOC(newPath, sizeof(struct __ASPath) + (count * path->nodeSize));
+        newPath->nodeSize = path->nodeSize;
+        newPath->count = count;
+        newPath->cost = path->cost;
+        memcpy(newPath->nodeKeys, path->nodeKeys + (idx * path->nodeSize), count * path->nodeSize);
+        return newPath;
+    } else {
+        return NULL;
+    }
+}
+
 size_t ASPathGetCount(ASPath path)
 {
     return path? path->count : 0;
@@ -35,6 +35,7 @@
 
 typedef struct __ASNeighborList *ASNeighborList;
 typedef struct __ASPath *ASPath;
+typedef struct __ASPathContext *ASPathContext;
 
 typedef struct {
     size_t  nodeSize;                                                                               // the size of the structure being used for the nodes - important since nodes are copied into the resulting path
@@ -42,6 +43,7 @@ typedef struct {
     float   (*pathCostHeuristic)(void *fromNode, void *toNode, void *context);                      // estimated cost to transition from the first node to the second node -- optional, uses 0 if not specified
     int     (*earlyExit)(size_t visitedCount, void *visitingNode, void *goalNode, void *context);   // early termination, return 1 for success, -1 for failure, 0 to continue searching -- optional
     int     (*nodeComparator)(void *node1, void *node2, void *context);                             // must return a sort order for the nodes (-1, 0, 1) -- optional, uses memcmp if not specified
+    size_t  (*nodeIndex)(void *node, void *context);                                                // unique index of the node, less than the path context's maxNodes, for faster lookups -- optional, only used by path contexts
 } ASPathNodeSource;
 
 // use in the nodeNeighbors callback to return neighbors
@@ -53,6 +55,14 @@ void ASNeighborListAdd(ASNeighborList neighbors, void *node, float edgeCost);
 // as a path is created, the relevant nodes are copied into the path
 ASPath ASPathCreate(const ASPathNodeSource *nodeSource, void *context, void *startNode, void *goalNode);
 
+// a path context keeps the search buffers between searches, to avoid reallocating them for every path
+// if the node source has nodeIndex, nodes are looked up directly by index; maxNodes must be greater than any index
+// must be destroyed with ASPathContextDestroy()
+ASPathContext ASPathContextCreate(const ASPathNodeSource *nodeSource, size_t maxNodes);
+void ASPathContextDestroy(ASPathContext pathContext);
+// like ASPathCreate(), but using the path context's buffers
+ASPath ASPathContextCreatePath(ASPathContext pathContext, void *context, void *startNode, void *goalNode);
+
 // paths created with ASPathCreate() must be destroyed or else it will leak memory
 void ASPathDestroy(ASPath path);
 
@@ -60,6 +70,10 @@ void ASPathDestroy(ASPath path);
 // you must call ASPathDestroy() with the resulting path to clean it up or it will cause a leak
 ASPath ASPathCopy(ASPath path);
 
+// like ASPathCopy(), but only copies the nodes from the given index onwards
+// the cost of the resulting path is left as the cost of the whole path
+ASPath ASPathCopyFrom(ASPath path, size_t idx);
+
 // fetches the number of nodes in the path
 size_t ASPathGetCount(ASPath path);
 
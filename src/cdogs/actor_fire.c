@@ -37,7 +37,7 @@ void ActorFire(Weapon *w, const TActor *a)
 		GameEvent e = GameEventNew(GAME_EVENT_GUN_STATE);
 		e.u.GunState.ActorUID = a->uid;
 		e.u.GunState.State = GUNSTATE_FIRING;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (!w->Gun->CanShoot)
 	{
@@ -75,6 +75,6 @@ void ActorFireUpdate(Weapon *w, const TActor *a, const int ticks)
 		const Vec2i muzzlePosition = Vec2iAdd(a->Pos, muzzleOffset);
 		e.u.GunReload.FullPos = Vec2i2Net(muzzlePosition);
 		e.u.GunReload.Direction = (int)a->direction;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
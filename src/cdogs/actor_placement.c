@@ -48,10 +48,9 @@ static NVec2i PlaceActor(Map *map)
 		// Don't try forever trying to place
 		for (int i = 0; i < 100; i++)
 		{
-			const Vec2i realPos = Vec2iNew(
-				rand() % (map->Size.x * TILE_WIDTH),
-				rand() % (map->Size.y * TILE_HEIGHT));
-			pos = Vec2iFull2Real(realPos);
+			const Vec2i realPos =
+				MapGetRandomFreePos(map, MAP_REGION_UNLOCKED);
+			pos = Vec2iReal2Full(realPos);
 			if (abs(realPos.x - exitPos.x) > halfMap &&
 				abs(realPos.y - exitPos.y) > halfMap &&
 				MapIsTileAreaClear(map, pos, Vec2iNew(ACTOR_W, ACTOR_H)))
@@ -64,8 +63,7 @@ static NVec2i PlaceActor(Map *map)
 	// Try to place randomly
 	do
 	{
-		pos.x = ((rand() % (map->Size.x * TILE_WIDTH)) << 8);
-		pos.y = ((rand() % (map->Size.y * TILE_HEIGHT)) << 8);
+		pos = Vec2iReal2Full(MapGetRandomFreePos(map, MAP_REGION_UNLOCKED));
 	} while (!MapIsFullPosOKforPlayer(map, pos, false) ||
 		!MapIsTileAreaClear(map, pos, Vec2iNew(ACTOR_W, ACTOR_H)));
 	return Vec2i2Net(pos);
@@ -125,9 +123,8 @@ NVec2i PlaceAwayFromPlayers(Map *map, const bool giveUp)
 	for (int i = 0; i < 100; i++)
 	{
 		// Try spawning out of players' sights
-		const Vec2i pos = Vec2iReal2Full(Vec2iNew(
-			rand() % (map->Size.x * TILE_WIDTH),
-			rand() % (map->Size.y * TILE_HEIGHT)));
+		const Vec2i pos =
+			Vec2iReal2Full(MapGetRandomFreePos(map, MAP_REGION_ANY));
 		const TActor *closestPlayer = AIGetClosestPlayer(pos);
 		if (closestPlayer && CHEBYSHEV_DISTANCE(
 			pos.x, pos.y,
@@ -141,9 +138,8 @@ NVec2i PlaceAwayFromPlayers(Map *map, const bool giveUp)
 	// even close to player
 	for (int i = 0; i < 10000 || !giveUp; i++)
 	{
-		const Vec2i pos = Vec2iReal2Full(Vec2iNew(
-			rand() % (map->Size.x * TILE_WIDTH),
-			rand() % (map->Size.y * TILE_HEIGHT)));
+		const Vec2i pos =
+			Vec2iReal2Full(MapGetRandomFreePos(map, MAP_REGION_ANY));
 		if (MapIsTileAreaClear(map, pos, Vec2iNew(ACTOR_W, ACTOR_H)))
 		{
 			return Vec2i2Net(pos);
@@ -160,8 +156,8 @@ NVec2i PlacePrisoner(Map *map)
 	{
 		do
 		{
-			fullPos.x = ((rand() % (map->Size.x * TILE_WIDTH)) << 8);
-			fullPos.y = ((rand() % (map->Size.y * TILE_HEIGHT)) << 8);
+			fullPos = Vec2iReal2Full(
+				MapGetRandomFreePos(map, MAP_REGION_LOCKED));
 		} while (!MapPosIsInLockedRoom(map, Vec2iFull2Real(fullPos)));
 	} while (!MapIsTileAreaClear(map, fullPos, Vec2iNew(ACTOR_W, ACTOR_H)));
 	return Vec2i2Net(fullPos);
@@ -202,7 +198,7 @@ Vec2i PlacePlayer(
 
 	GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 	e.u.ActorAdd = aa;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	if (pumpEvents)
 	{
@@ -56,6 +56,7 @@
 #include "actor_fire.h"
 #include "actor_placement.h"
 #include "ai_coop.h"
+#include "ai_index.h"
 #include "ai_utils.h"
 #include "ammo.h"
 #include "character.h"
@@ -269,7 +270,7 @@ bool TryMoveActor(TActor *actor, Vec2i pos)
 					{
 						e.u.Melee.HitType = (int)HIT_NONE;
 					}
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 				return false;
 			}
@@ -445,7 +446,7 @@ static void CheckTrigger(const Vec2i tilePos)
 			GameEvent e = GameEventNew(GAME_EVENT_TRIGGER);
 			e.u.TriggerEvent.ID = (*tp)->id;
 			e.u.TriggerEvent.Tile = Vec2i2Net(tilePos);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	CA_FOREACH_END()
 }
@@ -507,7 +508,7 @@ static void CheckRescue(const TActor *a)
 			other->flags &= ~FLAGS_PRISONER;
 			GameEvent e = GameEventNew(GAME_EVENT_RESCUE_CHARACTER);
 			e.u.Rescue.UID = other->uid;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			UpdateMissionObjective(
 				&gMission, other->tileItem.flags, OBJECTIVE_RESCUE, 1);
 		}
@@ -574,6 +575,7 @@ bool ActorUsesAmmo(const TActor *actor, const int ammoId)
 }
 
 static bool ActorHasGun(const TActor *a, const GunDescription *gun);
+static void ActorRefreshGun(TActor *a);
 void ActorReplaceGun(const NActorReplaceGun rg)
 {
 	TActor *a = ActorGetByUID(rg.UID);
@@ -599,6 +601,8 @@ void ActorReplaceGun(const NActorReplaceGun rg)
 	{
 		memcpy(CArrayGet(&a->guns, rg.GunIdx), &w, a->guns.elemSize);
 	}
+	// The guns may have been reallocated
+	ActorRefreshGun(a);
 
 	SoundPlayAt(&gSoundDevice, gun->SwitchSound, Vec2iFull2Real(a->Pos));
 }
@@ -655,7 +659,7 @@ void Shoot(TActor *actor)
 			e.u.UseAmmo.PlayerUID = actor->PlayerUID;
 			e.u.UseAmmo.AmmoId = gun->Gun->AmmoId;
 			e.u.UseAmmo.Amount = 1;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		else if (gun->Gun->Cost != 0)
 		{
@@ -663,7 +667,7 @@ void Shoot(TActor *actor)
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = actor->PlayerUID;
 			e.u.Score.Score = -gun->Gun->Cost;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -682,7 +686,7 @@ static bool ActorTryChangeDirection(
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_DIR);
 		e.u.ActorDir.UID = actor->uid;
 		e.u.ActorDir.Dir = (int32_t)dir;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		// Change direction immediately because this affects shooting
 		actor->direction = dir;
 	}
@@ -701,7 +705,7 @@ int ActorTryShoot(TActor *actor, int cmd)
 		GameEvent e = GameEventNew(GAME_EVENT_GUN_STATE);
 		e.u.GunState.ActorUID = actor->uid;
 		e.u.GunState.State = GUNSTATE_READY;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	return willShoot;
 }
@@ -728,7 +732,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 				e.u.ActorState.UID = actor->uid;
 				e.u.ActorState.State = (int32_t)ACTORANIMATION_IDLE;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 		}
 	}
@@ -748,7 +752,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_PICKUP_ALL);
 				e.u.ActorPickupAll.UID = actor->uid;
 				e.u.ActorPickupAll.PickupAll = true;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			actor->PickupAll = true;
 		}
@@ -761,7 +765,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_PICKUP_ALL);
 			e.u.ActorPickupAll.UID = actor->uid;
 			e.u.ActorPickupAll.PickupAll = false;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		actor->PickupAll = false;
 	}
@@ -801,7 +805,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 			e.u.ActorState.UID = actor->uid;
 			e.u.ActorState.State = (int32_t)ACTORANIMATION_WALKING;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 	else
@@ -811,7 +815,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 			e.u.ActorState.UID = actor->uid;
 			e.u.ActorState.State = (int32_t)ACTORANIMATION_IDLE;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 
@@ -822,7 +826,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 		e.u.ActorMove.UID = actor->uid;
 		e.u.ActorMove.Pos = Vec2i2Net(actor->Pos);
 		e.u.ActorMove.MoveVel = Vec2i2Net(actor->MoveVel);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	return willMove;
@@ -852,7 +856,7 @@ void SlideActor(TActor *actor, int cmd)
 	if (cmd & CMD_UP)			vel.y = -SLIDE_Y * 256;
 	else if (cmd & CMD_DOWN)	vel.y = SLIDE_Y * 256;
 	e.u.ActorSlide.Vel = Vec2i2Net(vel);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 	
 	actor->slideLock = SLIDE_LOCK;
 }
@@ -905,11 +909,11 @@ void UpdateAllActors(int ticks)
 					e.u.ActorImpulse.UID = actor->uid;
 					e.u.ActorImpulse.Vel = Vec2i2Net(v);
 					e.u.ActorImpulse.Pos = Vec2i2Net(actor->Pos);
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 					e.u.ActorImpulse.UID = collidingActor->uid;
 					e.u.ActorImpulse.Vel = Vec2i2Net(Vec2iScale(v, -1));
 					e.u.ActorImpulse.Pos = Vec2i2Net(collidingActor->Pos);
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 			}
 		}
@@ -1038,11 +1042,11 @@ static void ActorDie(TActor *actor)
 	e.u.MapObjectAdd.Pos = Vec2i2Net(Vec2iFull2Real(actor->Pos));
 	e.u.MapObjectAdd.TileItemFlags = MapObjectGetFlags(mo);
 	e.u.MapObjectAdd.Health = mo->Health;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	e = GameEventNew(GAME_EVENT_ACTOR_DIE);
 	e.u.ActorDie.UID = actor->uid;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 static bool IsUnarmedBot(const TActor *actor);
 static void ActorAddAmmoPickup(const TActor *actor)
@@ -1080,7 +1084,7 @@ static void ActorAddAmmoPickup(const TActor *actor)
 				RAND_INT(-TILE_WIDTH, TILE_WIDTH) / 2,
 				RAND_INT(-TILE_HEIGHT, TILE_HEIGHT) / 2);
 			e.u.AddPickup.Pos = Vec2i2Net(Vec2iAdd(Vec2iFull2Real(actor->Pos), offset));
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		CA_FOREACH_END()
 	}
 
@@ -1108,7 +1112,7 @@ static void ActorAddGunPickup(const TActor *actor)
 		e.u.AddPickup.SpawnerUID = -1;
 		e.u.AddPickup.TileItemFlags = 0;
 		e.u.AddPickup.Pos = Vec2i2Net(Vec2iFull2Real(actor->Pos));
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 static bool IsUnarmedBot(const TActor *actor)
@@ -1151,6 +1155,8 @@ int ActorsGetFreeIndex(void)
 }
 
 static void GoreEmitterInit(Emitter *em, const char *particleClassName);
+static const Character *ActorResolveCharacter(const TActor *a);
+static void ActorRefreshGun(TActor *a);
 TActor *ActorAdd(NActorAdd aa)
 {
 	// Don't add if UID exists
@@ -1184,7 +1190,8 @@ TActor *ActorAdd(NActorAdd aa)
 	}
 	actor->PlayerUID = aa.PlayerUID;
 	actor->charId = aa.CharId;
-	const Character *c = ActorGetCharacter(actor);
+	actor->character = ActorResolveCharacter(actor);
+	const Character *c = actor->character;
 	if (aa.PlayerUID >= 0)
 	{
 		// Add all player weapons
@@ -1203,6 +1210,7 @@ TActor *ActorAdd(NActorAdd aa)
 		CArrayPushBack(&actor->guns, &gun);
 	}
 	actor->gunIndex = 0;
+	ActorRefreshGun(actor);
 	actor->health = aa.Health;
 	actor->lastHealth = actor->health;
 	actor->action = ACTORACTION_MOVING;
@@ -1235,7 +1243,7 @@ TActor *ActorAdd(NActorAdd aa)
 			{
 				GameEvent e = GameEventNew(GAME_EVENT_RESCUE_CHARACTER);
 				e.u.Rescue.UID = aa.UID;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 				UpdateMissionObjective(
 					&gMission, actor->tileItem.flags, OBJECTIVE_RESCUE, 1);
 			}
@@ -1257,6 +1265,7 @@ TActor *ActorAdd(NActorAdd aa)
 	GoreEmitterInit(&actor->blood3, "blood3");
 
 	TryMoveActor(actor, Net2Vec2i(aa.FullPos));
+	AIIndexAddActor(&gAIIndex, actor);
 
 	// Spawn sound for player actors
 	if (aa.PlayerUID >= 0)
@@ -1297,7 +1306,7 @@ TActor *ActorGetByUID(const int uid)
 	return NULL;
 }
 
-const Character *ActorGetCharacter(const TActor *a)
+static const Character *ActorResolveCharacter(const TActor *a)
 {
 	if (a->PlayerUID >= 0)
 	{
@@ -1305,10 +1314,27 @@ const Character *ActorGetCharacter(const TActor *a)
 	}
 	return CArrayGet(&gCampaign.Setting.characters.OtherChars, a->charId);
 }
+const Character *ActorGetCharacter(const TActor *a)
+{
+	return a->character;
+}
+void ActorsRefreshPlayerCharacters(void)
+{
+	CA_FOREACH(TActor, a, gActors)
+		if (a->isInUse && a->PlayerUID >= 0)
+		{
+			a->character = ActorResolveCharacter(a);
+		}
+	CA_FOREACH_END()
+}
 
 Weapon *ActorGetGun(const TActor *a)
 {
-	return CArrayGet(&a->guns, a->gunIndex);
+	return a->gun;
+}
+static void ActorRefreshGun(TActor *a)
+{
+	a->gun = CArrayGet(&a->guns, a->gunIndex);
 }
 Vec2i ActorGetGunMuzzleOffset(const TActor *a)
 {
@@ -1342,6 +1368,7 @@ void ActorSwitchGun(const NActorSwitchGun sg)
 	if (a == NULL || !a->isInUse) return;
 	CASSERT(sg.GunIdx < a->guns.size, "can't switch to unavailable gun");
 	a->gunIndex = sg.GunIdx;
+	ActorRefreshGun(a);
 	SoundPlayAt(
 		&gSoundDevice,
 		ActorGetGun(a)->Gun->SwitchSound,
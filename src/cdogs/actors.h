@@ -125,6 +125,11 @@ typedef struct Actor
 	CArray guns;	// of Weapon
 	CArray ammo;	// of int
 	int gunIndex;
+	// Resolved character and current gun, so that they aren't looked up
+	// every tick; use ActorGetCharacter and ActorGetGun.
+	// Refreshed on add, gun switch/replace, and when player data changes.
+	const Character *character;
+	Weapon *gun;
 
 	int health;
 	int lastHealth;
@@ -196,6 +201,8 @@ void ActorDestroy(TActor *a);
 TActor *ActorGetByUID(const int uid);
 const Character *ActorGetCharacter(const TActor *a);
 Weapon *ActorGetGun(const TActor *a);
+// Re-resolve cached player characters after player data has moved
+void ActorsRefreshPlayerCharacters(void);
 Vec2i ActorGetGunMuzzleOffset(const TActor *a);
 // Returns -1 if gun does not use ammo
 int ActorGunGetAmmo(const TActor *a, const Weapon *w);
@@ -64,6 +64,7 @@
 #include "mission.h"
 #include "net_util.h"
 #include "sys_specifics.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 static int gBaddieCount = 0;
@@ -128,6 +129,53 @@ static bool CanSeeAPlayer(const TActor *a)
 }
 
 
+// AIs fall asleep if they are further than this from all players
+#define SLEEP_DISTANCE ((40 * 16) << 8)
+
+// AIs within this distance of a player, or that a player can see, think
+// every tick
+#define AI_LOD_NEAR_DISTANCE ((16 * 16) << 8)
+// AIs within this distance think every other tick, and the rest every
+// AI_LOD_FAR_INTERVAL ticks
+#define AI_LOD_MID_DISTANCE ((32 * 16) << 8)
+#define AI_LOD_FAR_INTERVAL 4
+// Maximum number of non-near AIs that think in a tick; the rest wait
+#define AI_LOD_THINK_BUDGET 32
+// Think serially if fewer AIs than this think in a tick; waking the
+// worker threads costs more than the line of sight checks would
+#define AI_PARALLEL_THINK_MIN 16
+
+static bool IsAIControlled(const TActor *a)
+{
+	return a->isInUse && !(a->PlayerUID >= 0 || (a->flags & FLAGS_PRISONER));
+}
+
+// Think phase: gather the expensive perception results for one AI.
+// Runs in parallel for all actors, so it must not modify anything apart
+// from the actor's own perception, and the world must not change until
+// all the AIs have finished thinking.
+static void AIThink(void *data, const int index)
+{
+	UNUSED(data);
+	const TActor *actor = CArrayGet(&gActors, index);
+	if (!IsAIControlled(actor))
+	{
+		return;
+	}
+	if (!actor->aiContext->Schedule.ShouldThink)
+	{
+		return;
+	}
+	AIPerception *p = &actor->aiContext->Perception;
+	const bool isReady = actor->aiContext->Delay == 0;
+	p->CanSeePlayer =
+		isReady && (actor->flags & FLAGS_SLEEPING) && CanSeeAPlayer(actor);
+	p->IsCloseToPlayer =
+		!isReady || (actor->flags & FLAGS_AWAKEALWAYS) ||
+		IsCloseToPlayer(actor->Pos, SLEEP_DISTANCE);
+}
+
+
 static bool IsPosOK(TActor *actor, Vec2i pos)
 {
 	const Vec2i realPos = Vec2iFull2Real(pos);
@@ -291,6 +339,77 @@ static bool DidPlayerShoot(void)
 }
 
 static int Follow(TActor *a);
+static int GetThinkInterval(const TActor *a);
+// Decide which AIs think this tick
+// Near AIs always do; the others take turns, with phases staggered by
+// actor index, and at most AI_LOD_THINK_BUDGET of them per tick.
+// This only depends on game state so it is deterministic.
+// Returns the number of AIs that think this tick.
+static int ScheduleThinks(void)
+{
+	int thinkers = 0;
+	const int n = (int)gActors.size;
+	int budget = AI_LOD_THINK_BUDGET;
+	// Start from a different actor each tick so that the same AIs are not
+	// always the ones that wait
+	const int start = n > 0 ? gMission.time % n : 0;
+	for (int i = 0; i < n; i++)
+	{
+		const int idx = (start + i) % n;
+		TActor *a = CArrayGet(&gActors, idx);
+		if (!IsAIControlled(a))
+		{
+			continue;
+		}
+		AIThinkSchedule *s = &a->aiContext->Schedule;
+		const int interval = GetThinkInterval(a);
+		if ((gMission.time + idx) % interval == 0)
+		{
+			s->IsThinkDue = true;
+		}
+		if (interval == 1)
+		{
+			s->ShouldThink = true;
+			s->IsThinkDue = false;
+			thinkers++;
+			continue;
+		}
+		s->ShouldThink = s->IsThinkDue && budget > 0;
+		if (s->ShouldThink)
+		{
+			s->IsThinkDue = false;
+			budget--;
+			thinkers++;
+		}
+	}
+	return thinkers;
+}
+static int GetThinkInterval(const TActor *a)
+{
+	if (a->dead ||
+		(a->flags & (FLAGS_VISIBLE | FLAGS_FOLLOWER | FLAGS_RESCUED)))
+	{
+		return 1;
+	}
+	const TActor *p = AIGetClosestPlayer(a->Pos);
+	if (p == NULL)
+	{
+		// No players to be far from
+		return 1;
+	}
+	const int distance =
+		CHEBYSHEV_DISTANCE(a->Pos.x, a->Pos.y, p->Pos.x, p->Pos.y);
+	if (distance < AI_LOD_NEAR_DISTANCE)
+	{
+		return 1;
+	}
+	else if (distance < AI_LOD_MID_DISTANCE)
+	{
+		return 2;
+	}
+	return AI_LOD_FAR_INTERVAL;
+}
+
 void CommandBadGuys(int ticks)
 {
 	int count = 0;
@@ -321,27 +440,58 @@ void CommandBadGuys(int ticks)
 		break;
 	}
 
+	const int thinkers = ScheduleThinks();
+
+	// Think in parallel, then act in order so that the results
+	// (including the use of rand()) are deterministic
+	if (thinkers < AI_PARALLEL_THINK_MIN)
+	{
+		for (int i = 0; i < (int)gActors.size; i++)
+		{
+			AIThink(NULL, i);
+		}
+	}
+	else
+	{
+		ThreadPoolParallelFor(
+			&gThreadPool, AIThink, NULL, (int)gActors.size);
+	}
+
 	CA_FOREACH(TActor, actor, gActors)
 		if (!actor->isInUse)
 		{
 			continue;
 		}
 		const CharBot *bot = ActorGetCharacter(actor)->bot;
-		if (!(actor->PlayerUID >= 0 || (actor->flags & FLAGS_PRISONER)))
+		if (IsAIControlled(actor))
 		{
+			const AIPerception *perception = &actor->aiContext->Perception;
 			if ((actor->flags & (FLAGS_VICTIM | FLAGS_GOOD_GUY)) != 0)
 			{
 				gAreGoodGuysPresent = 1;
 			}
 
 			count++;
+			if (!actor->aiContext->Schedule.ShouldThink)
+			{
+				// Not our turn; keep doing what we were doing
+				int cmd = 0;
+				if (!actor->dead && !(actor->flags & FLAGS_SLEEPING))
+				{
+					cmd = actor->lastCmd & ~CMD_BUTTON1;
+				}
+				actor->aiContext->Delay =
+					MAX(0, actor->aiContext->Delay - ticks);
+				CommandActor(actor, cmd, ticks);
+				continue;
+			}
 			int cmd = 0;
 
 			// Wake up if it can see a player
 			if ((actor->flags & FLAGS_SLEEPING) &&
 				actor->aiContext->Delay == 0)
 			{
-				if (CanSeeAPlayer(actor))
+				if (perception->CanSeePlayer)
 				{
 					actor->flags &= ~FLAGS_SLEEPING;
 					ActorSetAIState(actor, AI_STATE_NONE);
@@ -364,7 +514,7 @@ void CommandBadGuys(int ticks)
 				actor->aiContext->Delay == 0 &&
 				!(actor->flags & FLAGS_AWAKEALWAYS))
 			{
-				if (!IsCloseToPlayer(actor->Pos, (40 * 16) << 8))
+				if (!perception->IsCloseToPlayer)
 				{
 					actor->flags |= FLAGS_SLEEPING;
 					ActorSetAIState(actor, AI_STATE_IDLE);
@@ -501,7 +651,7 @@ void CommandBadGuys(int ticks)
 		aa.FullPos = PlaceAwayFromPlayers(&gMap, true);
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 		e.u.ActorAdd = aa;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		gBaddieCount++;
 	}
 }
@@ -526,7 +676,14 @@ static int Follow(TActor *a)
 	else
 	{
 		ActorSetAIState(a, AI_STATE_FOLLOW);
-		return AIGoto(a, AIGetClosestPlayerPos(a->Pos), true);
+		// Many actors may be following the same player;
+		// share a flow field towards them
+		const TActor *p = AIGetClosestPlayer(a->Pos);
+		if (p == NULL)
+		{
+			return 0;
+		}
+		return AIGotoFlow(a, p->uid, Vec2iFull2Real(p->Pos));
 	}
 }
 
@@ -550,7 +707,7 @@ void InitializeBadGuys(void)
 				aa.FullPos = PlaceAwayFromPlayers(&gMap, false);
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 
 				// Process the events that actually place the actors
 				HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -579,7 +736,7 @@ void InitializeBadGuys(void)
 				}
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 
 				// Process the events that actually place the actors
 				HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -614,7 +771,7 @@ void CreateEnemies(void)
 		aa.Health = CharacterGetStartingHealth(c, true);
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 		e.u.ActorAdd = aa;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		gBaddieCount++;
 
 		// Process the events that actually place the actors
@@ -36,6 +36,8 @@ AIContext *AIContextNew(void)
 	c->ChatterCounter = 2;
 	c->EnemyId = -1;
 	c->GunRangeScalar = 1.0;
+	c->Schedule.IsThinkDue = true;
+	CArrayInit(&c->Goto.Waypoints, sizeof(Vec2i));
 	return c;
 }
 void AIContextDestroy(AIContext *c)
@@ -43,6 +45,7 @@ void AIContextDestroy(AIContext *c)
 	if (c)
 	{
 		CachedPathDestroy(&c->Goto.Path);
+		CArrayTerminate(&c->Goto.Waypoints);
 	}
 	CFREE(c);
 }
@@ -87,7 +87,27 @@ typedef struct
 	CachedPath Path;
 	int PathIndex;
 	bool IsFollowing;
+	// Waypoints for long paths, found using the path chunks;
+	// Path only goes as far as the current waypoint
+	CArray Waypoints;	// of Vec2i
+	int WaypointIndex;
 } AIGotoContext;
+// Results of the read-only perception checks, gathered for all AIs in
+// parallel before any of them act
+typedef struct
+{
+	bool CanSeePlayer;
+	bool IsCloseToPlayer;
+} AIPerception;
+// Level of detail: AIs far from the players think less often
+typedef struct
+{
+	// Whether the AI has reached its turn to think but has not yet, because
+	// too many others were thinking
+	bool IsThinkDue;
+	// Whether the AI thinks this tick; otherwise it keeps doing what it was
+	bool ShouldThink;
+} AIThinkSchedule;
 typedef struct
 {
 	// Delay in executing consecutive actions;
@@ -106,6 +126,8 @@ typedef struct
 	int EnemyId;
 	double GunRangeScalar;
 	int OnGunId;
+	AIPerception Perception;
+	AIThinkSchedule Schedule;
 } AIContext;
 
 AIContext *AIContextNew(void);
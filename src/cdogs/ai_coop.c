@@ -28,6 +28,7 @@
 */
 #include "ai_coop.h"
 
+#include "ai_index.h"
 #include "ai_utils.h"
 #include "gamedata.h"
 #include "pickup.h"
@@ -143,16 +144,16 @@ static int AICoopGetCmdNormal(TActor *actor)
 		{
 			const Tile *t = MapGetTile(&gMap, v);
 			if (t == NULL) continue;
-			CA_FOREACH(const ThingId, tid, t->things)
+			TILE_FOREACH_THING(t, ti)
 				// Only look for bullets
-				if (tid->Kind != KIND_MOBILEOBJECT) continue;
-				const TMobileObject *mo = CArrayGet(&gMobObjs, tid->Id);
+				if (ti->kind != KIND_MOBILEOBJECT) continue;
+				const TMobileObject *mo = CArrayGet(&gMobObjs, ti->id);
 				if (mo->bulletClass->HurtAlways)
 				{
 					dangerBulletFullPos = Vec2iNew(mo->x, mo->y);
 					break;
 				}
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 	}
 	// Run away if dangerous bullet found
@@ -416,6 +417,12 @@ typedef struct
 	bool IsDestructible;
 	AIObjectiveType Type;
 } ClosestObjective;
+// Reused between calls, of ClosestObjective
+static CArray sObjectives;
+void AICoopTerminate(void)
+{
+	CArrayTerminate(&sObjectives);
+}
 static void FindObjectivesSortedByDistance(
 	CArray *objectives, const TActor *actor, const TActor *closestPlayer);
 static bool CanGetObjective(
@@ -495,12 +502,10 @@ static bool TryCompleteNearbyObjective(
 	}
 
 	// Find all the objective/key locations, sort according to distance
-	// TODO: reuse this array, don't recreate it
-	CArray objectives;
-	FindObjectivesSortedByDistance(&objectives, actor, closestPlayer);
+	FindObjectivesSortedByDistance(&sObjectives, actor, closestPlayer);
 
 	// Starting from the closest objectives, find one we can go to
-	CA_FOREACH(ClosestObjective, c, objectives)
+	CA_FOREACH(ClosestObjective, c, sObjectives)
 		if (CanGetObjective(
 			c->Pos, actorRealPos, closestPlayer, distanceTooFarFromPlayer))
 		{
@@ -541,7 +546,11 @@ static void FindObjectivesSortedByDistance(
 	CArray *objectives, const TActor *actor, const TActor *closestPlayer)
 {
 	const Vec2i actorRealPos = Vec2iFull2Real(actor->Pos);
-	CArrayInit(objectives, sizeof(ClosestObjective));
+	if (objectives->elemSize == 0)
+	{
+		CArrayInit(objectives, sizeof(ClosestObjective));
+	}
+	CArrayClear(objectives);
 
 	// If PVP, find the closest enemy and go to them
 	if (IsPVP(gCampaign.Entry.Mode))
@@ -563,8 +572,10 @@ static void FindObjectivesSortedByDistance(
 		}
 	}
 
-	// Look for pickups
-	CA_FOREACH(const Pickup, p, gPickups)
+	// Look for pickups, using the per-tick lists instead of scanning
+	// everything
+	CA_FOREACH(const int, pIdx, gAIIndex.Pickups)
+		const Pickup *p = CArrayGet(&gPickups, *pIdx);
 		if (!p->isInUse)
 		{
 			continue;
@@ -637,7 +648,8 @@ static void FindObjectivesSortedByDistance(
 	CA_FOREACH_END()
 
 	// Look for destructibles
-	CA_FOREACH(const TObject, o, gObjs)
+	CA_FOREACH(const int, oIdx, gAIIndex.Objectives)
+		const TObject *o = CArrayGet(&gObjs, *oIdx);
 		if (!o->isInUse)
 		{
 			continue;
@@ -663,7 +675,8 @@ static void FindObjectivesSortedByDistance(
 	CA_FOREACH_END()
 
 	// Look for kill or rescue objectives
-	CA_FOREACH(const TActor, a, gActors)
+	CA_FOREACH(const int, aIdx, gAIIndex.ObjectiveActors)
+		const TActor *a = CArrayGet(&gActors, *aIdx);
 		if (!a->isInUse)
 		{
 			continue;
@@ -34,3 +34,5 @@ int AICoopGetCmd(TActor *actor, const int ticks);
 void AICoopSelectWeapons(
 	PlayerData *p, const int player, const CArray *weapons);
 void AICoopOnPickupGun(TActor *a, const int gunId);
+// Free the buffers the co-op AI reuses between updates
+void AICoopTerminate(void);
@@ -0,0 +1,317 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "ai_index.h"
+
+#include <string.h>
+
+#include "objs.h"
+#include "pickup.h"
+#include "utils.h"
+
+AIIndex gAIIndex;
+
+// Size of the grid cells, in tiles
+#define AI_INDEX_CELL_TILES 8
+
+
+void AIIndexInit(AIIndex *idx)
+{
+	memset(idx, 0, sizeof *idx);
+	CArrayInit(&idx->CellStarts, sizeof(int));
+	CArrayInit(&idx->CellActors, sizeof(int));
+	CArrayInit(&idx->Added, sizeof(int));
+	CArrayInit(&idx->Pickups, sizeof(int));
+	CArrayInit(&idx->Objectives, sizeof(int));
+	CArrayInit(&idx->ObjectiveActors, sizeof(int));
+	CArrayInit(&idx->ClosestEnemies, sizeof(AIIndexClosest));
+}
+void AIIndexTerminate(AIIndex *idx)
+{
+	CArrayTerminate(&idx->CellStarts);
+	CArrayTerminate(&idx->CellActors);
+	CArrayTerminate(&idx->Added);
+	CArrayTerminate(&idx->Pickups);
+	CArrayTerminate(&idx->Objectives);
+	CArrayTerminate(&idx->ObjectiveActors);
+	CArrayTerminate(&idx->ClosestEnemies);
+	memset(idx, 0, sizeof *idx);
+}
+
+static int GetCell(const AIIndex *idx, const Vec2i fullPos);
+void AIIndexUpdate(AIIndex *idx, const Map *map)
+{
+	idx->IsBuilt = true;
+	idx->Size = Vec2iNew(
+		MAX(1, (map->Size.x + AI_INDEX_CELL_TILES - 1) / AI_INDEX_CELL_TILES),
+		MAX(1, (map->Size.y + AI_INDEX_CELL_TILES - 1) / AI_INDEX_CELL_TILES));
+	const int numCells = idx->Size.x * idx->Size.y;
+
+	// Bucket the actors by cell with a counting sort:
+	// count into the next cell's start, then sum to get the starts
+	CArrayClear(&idx->CellStarts);
+	const int zero = 0;
+	CArrayResize(&idx->CellStarts, numCells + 1, &zero);
+	int *starts = idx->CellStarts.data;
+	int numActors = 0;
+	CA_FOREACH(const TActor, a, gActors)
+		if (!a->isInUse)
+		{
+			continue;
+		}
+		starts[GetCell(idx, a->Pos) + 1]++;
+		numActors++;
+	CA_FOREACH_END()
+	for (int i = 1; i <= numCells; i++)
+	{
+		starts[i] += starts[i - 1];
+	}
+	CArrayResize(&idx->CellActors, numActors, NULL);
+	int *cellActors = idx->CellActors.data;
+	CA_FOREACH(const TActor, a, gActors)
+		if (!a->isInUse)
+		{
+			continue;
+		}
+		cellActors[starts[GetCell(idx, a->Pos)]++] = _ca_index;
+	CA_FOREACH_END()
+	// Filling moved each start to the end of its cell; shift them back
+	for (int i = numCells; i > 0; i--)
+	{
+		starts[i] = starts[i - 1];
+	}
+	starts[0] = 0;
+	CArrayClear(&idx->Added);
+
+	CArrayClear(&idx->Pickups);
+	CA_FOREACH(const Pickup, p, gPickups)
+		if (p->isInUse)
+		{
+			CArrayPushBack(&idx->Pickups, &_ca_index);
+		}
+	CA_FOREACH_END()
+	CArrayClear(&idx->Objectives);
+	CA_FOREACH(const TObject, o, gObjs)
+		if (o->isInUse && (o->tileItem.flags & TILEITEM_OBJECTIVE))
+		{
+			CArrayPushBack(&idx->Objectives, &_ca_index);
+		}
+	CA_FOREACH_END()
+	CArrayClear(&idx->ObjectiveActors);
+	CA_FOREACH(const TActor, a, gActors)
+		if (a->isInUse && (a->tileItem.flags & TILEITEM_OBJECTIVE))
+		{
+			CArrayPushBack(&idx->ObjectiveActors, &_ca_index);
+		}
+	CA_FOREACH_END()
+
+	AIIndexClosest c;
+	c.FromUID = -1;
+	c.IsPlayer = false;
+	c.Index = -1;
+	c.UID = -1;
+	CArrayClear(&idx->ClosestEnemies);
+	CArrayResize(&idx->ClosestEnemies, gActors.size, &c);
+}
+static int GetCell(const AIIndex *idx, const Vec2i fullPos)
+{
+	const Vec2i tile = Vec2iToTile(Vec2iFull2Real(fullPos));
+	const int x = CLAMP(tile.x / AI_INDEX_CELL_TILES, 0, idx->Size.x - 1);
+	const int y = CLAMP(tile.y / AI_INDEX_CELL_TILES, 0, idx->Size.y - 1);
+	return y * idx->Size.x + x;
+}
+
+void AIIndexClear(AIIndex *idx)
+{
+	idx->IsBuilt = false;
+}
+
+void AIIndexAddActor(AIIndex *idx, const TActor *a)
+{
+	if (!idx->IsBuilt)
+	{
+		return;
+	}
+	const int i = (int)(a - (const TActor *)gActors.data);
+	CArrayPushBack(&idx->Added, &i);
+}
+
+typedef struct
+{
+	Vec2i FullPos;
+	AIIndexActorFilter Filter;
+	const void *Data;
+	TActor *Closest;
+	int ClosestIndex;
+	int MinDistance;
+} ClosestActorQuery;
+static void TryActor(ClosestActorQuery *q, const int i);
+TActor *AIIndexGetClosestActor(
+	const AIIndex *idx, const Vec2i fullPos,
+	AIIndexActorFilter filter, const void *data)
+{
+	ClosestActorQuery q;
+	q.FullPos = fullPos;
+	q.Filter = filter;
+	q.Data = data;
+	q.Closest = NULL;
+	q.ClosestIndex = -1;
+	q.MinDistance = -1;
+	if (!idx->IsBuilt)
+	{
+		for (int i = 0; i < (int)gActors.size; i++)
+		{
+			TryActor(&q, i);
+		}
+		return q.Closest;
+	}
+
+	CA_FOREACH(const int, i, idx->Added)
+		TryActor(&q, *i);
+	CA_FOREACH_END()
+
+	// Visit rings of cells around the query, nearest first
+	const int cell = GetCell(idx, fullPos);
+	const int cx = cell % idx->Size.x;
+	const int cy = cell / idx->Size.x;
+	const int cellFullSize = MIN(
+		AI_INDEX_CELL_TILES * TILE_WIDTH,
+		AI_INDEX_CELL_TILES * TILE_HEIGHT) << 8;
+	const int maxRing = MAX(idx->Size.x, idx->Size.y);
+	const int *starts = idx->CellStarts.data;
+	const int *cellActors = idx->CellActors.data;
+	for (int r = 0; r <= maxRing; r++)
+	{
+		// Actors in this ring are at least r - 1 cells away; allow another
+		// cell for actors that have moved since the rebuild
+		if (q.Closest != NULL && (r - 2) * cellFullSize > q.MinDistance)
+		{
+			break;
+		}
+		for (int y = cy - r; y <= cy + r; y++)
+		{
+			if (y < 0 || y >= idx->Size.y)
+			{
+				continue;
+			}
+			// Only the ends of the middle rows are part of the ring
+			const bool isEdgeRow = y == cy - r || y == cy + r;
+			const int step = isEdgeRow ? 1 : 2 * r;
+			for (int x = cx - r; x <= cx + r; x += step)
+			{
+				if (x < 0 || x >= idx->Size.x)
+				{
+					continue;
+				}
+				const int c = y * idx->Size.x + x;
+				for (int j = starts[c]; j < starts[c + 1]; j++)
+				{
+					TryActor(&q, cellActors[j]);
+				}
+			}
+		}
+	}
+	return q.Closest;
+}
+static void TryActor(ClosestActorQuery *q, const int i)
+{
+	TActor *a = CArrayGet(&gActors, i);
+	if (!a->isInUse || !q->Filter(a, q->Data))
+	{
+		return;
+	}
+	const int distance = CHEBYSHEV_DISTANCE(
+		q->FullPos.x, q->FullPos.y, a->Pos.x, a->Pos.y);
+	// Break ties in favour of earlier actors, to match a full scan
+	if (q->Closest == NULL || distance < q->MinDistance ||
+		(distance == q->MinDistance && i < q->ClosestIndex))
+	{
+		q->Closest = a;
+		q->ClosestIndex = i;
+		q->MinDistance = distance;
+	}
+}
+
+static AIIndexClosest *GetClosestEnemy(
+	const AIIndex *idx, const TActor *from);
+bool AIIndexTryGetClosestEnemy(
+	const AIIndex *idx, const TActor *from, const bool isPlayer,
+	const TActor **closest)
+{
+	const AIIndexClosest *c = GetClosestEnemy(idx, from);
+	if (c == NULL || c->FromUID != from->uid || c->IsPlayer != isPlayer)
+	{
+		return false;
+	}
+	if (c->Index < 0)
+	{
+		*closest = NULL;
+		return true;
+	}
+	// Check that the enemy is still around
+	const TActor *a = CArrayGet(&gActors, c->Index);
+	if (!a->isInUse || a->dead || a->uid != c->UID)
+	{
+		return false;
+	}
+	*closest = a;
+	return true;
+}
+void AIIndexSetClosestEnemy(
+	AIIndex *idx, const TActor *from, const bool isPlayer,
+	const TActor *closest)
+{
+	AIIndexClosest *c = GetClosestEnemy(idx, from);
+	if (c == NULL)
+	{
+		return;
+	}
+	c->FromUID = from->uid;
+	c->IsPlayer = isPlayer;
+	c->Index = -1;
+	c->UID = -1;
+	if (closest != NULL)
+	{
+		c->Index = (int)(closest - (const TActor *)gActors.data);
+		c->UID = closest->uid;
+	}
+}
+static AIIndexClosest *GetClosestEnemy(
+	const AIIndex *idx, const TActor *from)
+{
+	if (!idx->IsBuilt)
+	{
+		return NULL;
+	}
+	const int i = (int)(from - (const TActor *)gActors.data);
+	if (i < 0 || i >= (int)idx->ClosestEnemies.size)
+	{
+		return NULL;
+	}
+	return CArrayGet(&idx->ClosestEnemies, i);
+}
@@ -0,0 +1,94 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "actors.h"
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Spatial index of the things AIs look for, rebuilt once per game tick
+// Actors are bucketed in a coarse grid so that closest-actor queries only
+// visit the cells around the query, nearest first. Pickups and objective
+// things are gathered in lists so that AIs do not scan every object.
+// Actors added during a tick are kept in a separate list until the next
+// rebuild, whereas pickups and objectives added during a tick are only
+// found from the next tick. All other state (in use, dead, flags, position)
+// is checked when queried.
+typedef struct
+{
+	bool IsBuilt;
+	Vec2i Size;	// in cells
+	// Actor indices sorted by cell; cell i's actors are in
+	// [CellStarts[i], CellStarts[i + 1])
+	CArray CellStarts;	// of int
+	CArray CellActors;	// of int, index into gActors
+	CArray Added;	// of int, actors added since the last rebuild
+	CArray Pickups;	// of int, index into gPickups
+	CArray Objectives;	// of int, index into gObjs, for objective objects
+	CArray ObjectiveActors;	// of int, index into gActors
+	// Closest visible enemy of each actor, found at most once per tick
+	CArray ClosestEnemies;	// of AIIndexClosest, by index into gActors
+} AIIndex;
+typedef struct
+{
+	int FromUID;	// -1 if not yet found this tick
+	bool IsPlayer;
+	int Index;	// index into gActors, or -1 if there is no enemy
+	int UID;
+} AIIndexClosest;
+
+extern AIIndex gAIIndex;
+
+void AIIndexInit(AIIndex *idx);
+void AIIndexTerminate(AIIndex *idx);
+// Rebuild for the current state of the map and things
+void AIIndexUpdate(AIIndex *idx, const Map *map);
+// Stop using the index, e.g. once the game is over;
+// queries fall back to scanning everything
+void AIIndexClear(AIIndex *idx);
+void AIIndexAddActor(AIIndex *idx, const TActor *a);
+
+// Filter for actor queries; data is passed through
+typedef bool (*AIIndexActorFilter)(const TActor *a, const void *data);
+// Find the actor closest to a position (by Chebyshev distance, in full
+// coordinates) that passes the filter; ties go to the earlier actor
+TActor *AIIndexGetClosestActor(
+	const AIIndex *idx, const Vec2i fullPos,
+	AIIndexActorFilter filter, const void *data);
+// Get the cached closest enemy of an actor for this tick
+// Returns false if it has not been found yet this tick
+bool AIIndexTryGetClosestEnemy(
+	const AIIndex *idx, const TActor *from, const bool isPlayer,
+	const TActor **closest);
+void AIIndexSetClosestEnemy(
+	AIIndex *idx, const TActor *from, const bool isPlayer,
+	const TActor *closest);
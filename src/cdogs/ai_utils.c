@@ -50,6 +50,7 @@
 
 #include <assert.h>
 
+#include "ai_index.h"
 #include "algorithms.h"
 #include "collision/collision.h"
 #include "gamedata.h"
@@ -80,36 +81,35 @@ TActor *AIGetClosestPlayer(Vec2i fullpos)
 	return closestPlayer;
 }
 
+typedef struct
+{
+	const TActor *From;
+	bool (*CompFunc)(const TActor *, const TActor *);
+} ClosestActorData;
+static bool IsTargetable(const TActor *a, const void *data)
+{
+	const ClosestActorData *cad = data;
+	if (a->dead)
+	{
+		return false;
+	}
+	// Never target invulnerables or civilians
+	if (a->flags & (FLAGS_INVULNERABLE | FLAGS_PENALTY))
+	{
+		return false;
+	}
+	return cad->CompFunc(a, cad->From);
+}
 static TActor *AIGetClosestActor(
 	const Vec2i fromPos, const TActor *from,
 	bool (*compFunc)(const TActor *, const TActor *))
 {
-	// Search all the actors and find the closest one that
-	// satisfies the condition
-	TActor *closest = NULL;
-	int minDistance = -1;
-	CA_FOREACH(TActor, a, gActors)
-		if (!a->isInUse || a->dead)
-		{
-			continue;
-		}
-		// Never target invulnerables or civilians
-		if (a->flags & (FLAGS_INVULNERABLE | FLAGS_PENALTY))
-		{
-			continue;
-		}
-		if (compFunc(a, from))
-		{
-			int distance = CHEBYSHEV_DISTANCE(
-				fromPos.x, fromPos.y, a->Pos.x, a->Pos.y);
-			if (!closest || distance < minDistance)
-			{
-				minDistance = distance;
-				closest = a;
-			}
-		}
-	CA_FOREACH_END()
-	return closest;
+	// Find the closest actor that satisfies the condition,
+	// searching outwards from the position
+	ClosestActorData cad;
+	cad.From = from;
+	cad.CompFunc = compFunc;
+	return AIIndexGetClosestActor(&gAIIndex, fromPos, IsTargetable, &cad);
 }
 
 static bool IsGood(const TActor *a, const TActor *b)
@@ -153,8 +153,22 @@ static bool IsBadAndVisible(const TActor *a, const TActor *b)
 {
 	return IsBad(a, b) && (a->flags & FLAGS_VISIBLE);
 }
+static const TActor *FindClosestVisibleEnemy(
+	const TActor *from, const bool isPlayer);
 const TActor *AIGetClosestVisibleEnemy(
 	const TActor *from, const bool isPlayer)
+{
+	// AIs ask for this several times a tick; only search once
+	const TActor *closest;
+	if (!AIIndexTryGetClosestEnemy(&gAIIndex, from, isPlayer, &closest))
+	{
+		closest = FindClosestVisibleEnemy(from, isPlayer);
+		AIIndexSetClosestEnemy(&gAIIndex, from, isPlayer, closest);
+	}
+	return closest;
+}
+static const TActor *FindClosestVisibleEnemy(
+	const TActor *from, const bool isPlayer)
 {
 	if (IsPVP(gCampaign.Entry.Mode))
 	{
@@ -231,18 +245,18 @@ bool IsTileWalkable(Map *map, const Vec2i pos)
 	// Check if tile has a dangerous (explosive) item on it
 	// For AI, we don't want to shoot it, so just walk around
 	Tile *t = MapGetTile(map, pos);
-	CA_FOREACH(ThingId, tid, t->things)
+	TILE_FOREACH_THING(t, ti)
 		// Only look for explosive objects
-		if (tid->Kind != KIND_OBJECT)
+		if (ti->kind != KIND_OBJECT)
 		{
 			continue;
 		}
-		const TObject *o = CArrayGet(&gObjs, tid->Id);
+		const TObject *o = CArrayGet(&gObjs, ti->id);
 		if (ObjIsDangerous(o))
 		{
 			return false;
 		}
-	CA_FOREACH_END()
+	TILE_FOREACH_THING_END()
 	return true;
 }
 static bool IsPosNoWalk(void *data, Vec2i pos)
@@ -257,17 +271,17 @@ bool IsTileWalkableAroundObjects(Map *map, const Vec2i pos)
 	}
 	// Check if tile has any item on it
 	Tile *t = MapGetTile(map, pos);
-	CA_FOREACH(ThingId, tid, t->things)
-		if (tid->Kind == KIND_OBJECT)
+	TILE_FOREACH_THING(t, ti)
+		if (ti->kind == KIND_OBJECT)
 		{
 			// Check that the object has hitbox - i.e. health > 0
-			const TObject *o = CArrayGet(&gObjs, tid->Id);
+			const TObject *o = CArrayGet(&gObjs, ti->id);
 			if (o->Health > 0)
 			{
 				return false;
 			}
 		}
-		else if (tid->Kind == KIND_CHARACTER)
+		else if (ti->kind == KIND_CHARACTER)
 		{
 			switch (gCollisionSystem.allyCollision)
 			{
@@ -285,7 +299,7 @@ bool IsTileWalkableAroundObjects(Map *map, const Vec2i pos)
 				break;
 			}
 		}
-	CA_FOREACH_END()
+	TILE_FOREACH_THING_END()
 	return true;
 }
 static bool IsPosNoWalkAroundObjects(void *data, Vec2i pos)
@@ -294,12 +308,8 @@ static bool IsPosNoWalkAroundObjects(void *data, Vec2i pos)
 }
 static bool IsTileWalkableOrOpenable(Map *map, Vec2i pos)
 {
-	const Tile *tile = MapGetTile(map, pos);
-	if (tile == NULL)
-	{
-		return false;
-	}
-	const int tileFlags = tile->flags;
+	// Tiles outside the map are not walkable and not doors
+	const int tileFlags = MapGetTileFlags(map, pos);
 	if (!(tileFlags & MAPTILE_NO_WALK))
 	{
 		return true;
@@ -355,7 +365,7 @@ bool AIHasClearShot(const Vec2i from, const Vec2i to)
 }
 static bool IsPosNoSee(void *data, Vec2i pos)
 {
-	return MapGetTile(data, Vec2iToTile(pos))->flags & MAPTILE_NO_SEE;
+	return MapGetTileFlags(data, Vec2iToTile(pos)) & MAPTILE_NO_SEE;
 }
 
 TObject *AIGetObjectRunningInto(TActor *a, int cmd)
@@ -498,7 +508,16 @@ static int AStarCloseToPath(
 		return 0;
 	}
 	// Check if we're too far from the end of the path
-	pathEnd = ASPathGetNode(c->Path.Path, ASPathGetCount(c->Path.Path) - 1);
+	// For long paths, this is the last waypoint
+	if (c->Waypoints.size > 0)
+	{
+		pathEnd = CArrayGet(&c->Waypoints, (int)c->Waypoints.size - 1);
+	}
+	else
+	{
+		pathEnd =
+			ASPathGetNode(c->Path.Path, ASPathGetCount(c->Path.Path) - 1);
+	}
 	if (CHEBYSHEV_DISTANCE(
 		goalTile.x, goalTile.y, pathEnd->x, pathEnd->y) > 0)
 	{
@@ -506,6 +525,45 @@ static int AStarCloseToPath(
 	}
 	return 1;
 }
+// For long paths, when we've reached the end of the current part of
+// the path, find the path to the next waypoint
+static bool AIGotoNextWaypoint(
+	AIGotoContext *c, const Vec2i currentTile, const Vec2i goalTile,
+	const bool ignoreObjects)
+{
+	if (c->WaypointIndex >= (int)c->Waypoints.size - 1)
+	{
+		return false;
+	}
+	// Check that the goal hasn't moved
+	const Vec2i *pathEnd =
+		CArrayGet(&c->Waypoints, (int)c->Waypoints.size - 1);
+	if (!Vec2iEqual(*pathEnd, goalTile))
+	{
+		return false;
+	}
+	// Check that we're near the current waypoint
+	const Vec2i *waypoint = CArrayGet(&c->Waypoints, c->WaypointIndex);
+	if (CHEBYSHEV_DISTANCE(
+		currentTile.x, currentTile.y, waypoint->x, waypoint->y) > 2)
+	{
+		return false;
+	}
+	while (c->WaypointIndex < (int)c->Waypoints.size - 1)
+	{
+		c->WaypointIndex++;
+		waypoint = CArrayGet(&c->Waypoints, c->WaypointIndex);
+		c->PathIndex = 1;
+		CachedPathDestroy(&c->Path);
+		c->Path = PathCacheCreate(
+			&gPathCache, currentTile, *waypoint, ignoreObjects, true);
+		if (ASPathGetCount(c->Path.Path) > 1)
+		{
+			return true;
+		}
+	}
+	return false;
+}
 int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 {
 	Vec2i a = Vec2iFull2Real(actor->Pos);
@@ -530,6 +588,11 @@ int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 	{
 		return AStarFollow(c, currentTile, &actor->tileItem, a);
 	}
+	else if (c->IsFollowing &&
+		AIGotoNextWaypoint(c, currentTile, goalTile, ignoreObjects))
+	{
+		return AStarFollow(c, currentTile, &actor->tileItem, a);
+	}
 	else if (AIHasClearPath(a, p, ignoreObjects))
 	{
 		// Simple case: if there's a clear line between AI and target,
@@ -546,10 +609,20 @@ int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 			&gMap, goalTile,
 			ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects);
 
+		// For long paths, find a rough path through the map's chunks first,
+		// and only find the tile path to the first waypoint
+		c->WaypointIndex = 0;
+		Vec2i pathGoal = c->Goal;
+		if (PathChunksFindWaypoints(
+			&gPathCache.Chunks, currentTile, c->Goal, &c->Waypoints))
+		{
+			pathGoal = *(const Vec2i *)CArrayGet(&c->Waypoints, 0);
+		}
+
 		c->PathIndex = 1;	// start navigating to the next path node
 		CachedPathDestroy(&c->Path);
 		c->Path = PathCacheCreate(
-			&gPathCache, currentTile, c->Goal, ignoreObjects, true);
+			&gPathCache, currentTile, pathGoal, ignoreObjects, true);
 
 		// In case we can't calculate A* for some reason,
 		// try simple navigation again
@@ -567,6 +640,37 @@ int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 	}
 }
 
+int AIGotoFlow(TActor *actor, const int targetId, const Vec2i target)
+{
+	const Vec2i a = Vec2iFull2Real(actor->Pos);
+	const Vec2i currentTile = Vec2iToTile(a);
+	const Vec2i goalTile = Vec2iToTile(target);
+
+	if (Vec2iEqual(currentTile, goalTile) ||
+		AIHasClearPath(a, target, true))
+	{
+		return AIGotoDirect(a, target);
+	}
+
+	// Make sure the actor is fully within the current tile before
+	// heading to the next, otherwise it may get stuck at corners
+	if (!IsTileItemInsideTile(&actor->tileItem, currentTile))
+	{
+		return AIGotoDirect(a, Vec2iCenterOfTile(currentTile));
+	}
+
+	const FlowField *f = FlowFieldsGet(
+		&gPathCache.FlowFields, targetId, goalTile, gMission.time);
+	Vec2i next;
+	if (!FlowFieldGetNextTile(&gPathCache.FlowFields, f, currentTile, &next))
+	{
+		// We may be somewhere the field can't reach, e.g. standing in
+		// a doorway; find our own path instead
+		return AIGoto(actor, target, true);
+	}
+	return AIGotoDirect(a, Vec2iCenterOfTile(next));
+}
+
 // Hunt moves an Actor towards a target, using the most efficient direction.
 // That is, given the following octant:
 //            x  A      xxxx
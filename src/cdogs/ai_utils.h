@@ -72,6 +72,11 @@ bool AIIsFacing(const TActor *a, const Vec2i targetFull, const direction_e d);
 //                - if false, will pathfind around them
 int AIGoto(TActor *actor, Vec2i target, bool ignoreObjects);
 int AIGotoDirect(const Vec2i a, const Vec2i p);
+// Go to a target that many actors may be going to, e.g. a player, using a
+// flow field shared by all of them instead of finding a path each
+// targetId - identifies the target, e.g. the target actor's UID
+// Obstructing objects are ignored, like AIGoto(..., true)
+int AIGotoFlow(TActor *actor, const int targetId, const Vec2i target);
 int AIHunt(TActor *actor, Vec2i targetPos);
 int AIHuntClosest(TActor *actor);
 int AIRetreatFrom(TActor *actor, const Vec2i from);
@@ -28,6 +28,9 @@
 #include "algorithms.h"
 
 #include <math.h>
+#include <string.h>
+
+#include "c_array.h"
 
 
 typedef struct
@@ -276,16 +279,91 @@ void XiaolinWuLineDraw(Vec2i from, Vec2i to, AlgoLineDrawData *data)
 	XiaolinWuLine(from, to, &bData);
 }
 
+// Buffers reused between flood fills
+static CArray sFloodFillStack;	// of Vec2i, seeds for spans
+static CArray sFloodFillVisited;	// of bool
+static bool FloodFillCanFill(const FloodFillData *data, const Vec2i v)
+{
+	if (v.x < 0 || v.x >= data->Size.x || v.y < 0 || v.y >= data->Size.y)
+	{
+		return false;
+	}
+	const bool *visited = sFloodFillVisited.data;
+	return !visited[v.y * data->Size.x + v.x] && data->IsSame(data->data, v);
+}
+// Add seeds for each run of fillable tiles in a row
+static void FloodFillScanRow(
+	const FloodFillData *data, const int x0, const int x1, const int y)
+{
+	bool inSpan = false;
+	for (int x = x0; x <= x1; x++)
+	{
+		const Vec2i v = Vec2iNew(x, y);
+		if (FloodFillCanFill(data, v))
+		{
+			if (!inSpan)
+			{
+				CArrayPushBack(&sFloodFillStack, &v);
+			}
+			inSpan = true;
+		}
+		else
+		{
+			inSpan = false;
+		}
+	}
+}
 bool CFloodFill(Vec2i v, FloodFillData *data)
 {
-	if (data->IsSame(data->data, v))
+	if (sFloodFillStack.elemSize == 0)
 	{
-		data->Fill(data->data, v);
-		CFloodFill(Vec2iNew(v.x - 1, v.y), data);
-		CFloodFill(Vec2iNew(v.x + 1, v.y), data);
-		CFloodFill(Vec2iNew(v.x, v.y - 1), data);
-		CFloodFill(Vec2iNew(v.x, v.y + 1), data);
-		return true;
+		CArrayInit(&sFloodFillStack, sizeof(Vec2i));
+		CArrayInit(&sFloodFillVisited, sizeof(bool));
+	}
+	CArrayResize(&sFloodFillVisited, data->Size.x * data->Size.y, NULL);
+	if (sFloodFillVisited.size > 0)
+	{
+		memset(sFloodFillVisited.data, 0, sFloodFillVisited.size);
 	}
-	return false;
+	if (!FloodFillCanFill(data, v))
+	{
+		return false;
+	}
+	CArrayClear(&sFloodFillStack);
+	CArrayPushBack(&sFloodFillStack, &v);
+	while (sFloodFillStack.size > 0)
+	{
+		const Vec2i seed = *(const Vec2i *)CArrayGet(
+			&sFloodFillStack, (int)sFloodFillStack.size - 1);
+		CArrayDelete(&sFloodFillStack, (int)sFloodFillStack.size - 1);
+		// The seed may have been filled since it was added
+		if (!FloodFillCanFill(data, seed))
+		{
+			continue;
+		}
+		// Find the extent of the span
+		int x0 = seed.x;
+		int x1 = seed.x;
+		while (FloodFillCanFill(data, Vec2iNew(x0 - 1, seed.y)))
+		{
+			x0--;
+		}
+		while (FloodFillCanFill(data, Vec2iNew(x1 + 1, seed.y)))
+		{
+			x1++;
+		}
+		// Fill it
+		bool *visited = sFloodFillVisited.data;
+		memset(
+			&visited[seed.y * data->Size.x + x0], true,
+			(x1 - x0 + 1) * sizeof *visited);
+		for (int x = x0; x <= x1; x++)
+		{
+			data->Fill(data->data, Vec2iNew(x, seed.y));
+		}
+		// Add the spans above and below
+		FloodFillScanRow(data, x0, x1, seed.y - 1);
+		FloodFillScanRow(data, x0, x1, seed.y + 1);
+	}
+	return true;
 }
@@ -53,8 +53,13 @@ typedef struct
 {
 	void (*Fill)(void *, Vec2i);
 	bool (*IsSame)(void *, Vec2i);
+	// Size of the area; tiles outside it are never filled
+	Vec2i Size;
 	void *data;
 } FloodFillData;
+// Scanline flood fill, filling each tile at most once
+// Returns whether any tiles were filled
+// Note: not reentrant; uses shared buffers
 bool CFloodFill(Vec2i v, FloodFillData *data);
 
 #endif
@@ -198,51 +198,175 @@ void DrawDot(TTileItem *t, color_t color, Vec2i pos, int scale)
 	Draw_Rect(pos.x, pos.y, scale, scale, color);
 }
 
+// Cached colours of the map tiles; alpha 0 for tiles not drawn
+// There is one cache for explored tiles and one for all tiles (showAll),
+// so switching between them doesn't rebuild either.
+// Changed tiles are updated when the map is next drawn; if too many pile up,
+// e.g. because the automap isn't being shown, rebuild the whole map instead.
+#define AUTOMAP_DIRTY_TILES_MAX 1024
+typedef struct
+{
+	const Map *Map;
+	Vec2i Size;
+	bool IsDirty;
+	CArray Colors;	// of color_t
+	CArray DirtyTiles;	// of Vec2i
+} AutomapCache;
+static AutomapCache sCaches[2];	// indexed by showAll
+
+void AutomapInvalidate(void)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		AutomapCache *c = &sCaches[i];
+		c->IsDirty = true;
+		if (c->DirtyTiles.elemSize != 0)
+		{
+			CArrayClear(&c->DirtyTiles);
+		}
+	}
+}
+void AutomapInvalidateTile(const Vec2i tile)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		AutomapCache *c = &sCaches[i];
+		if (c->IsDirty)
+		{
+			continue;
+		}
+		if (c->DirtyTiles.elemSize == 0)
+		{
+			CArrayInit(&c->DirtyTiles, sizeof(Vec2i));
+		}
+		if (c->DirtyTiles.size >= AUTOMAP_DIRTY_TILES_MAX)
+		{
+			c->IsDirty = true;
+			CArrayClear(&c->DirtyTiles);
+			continue;
+		}
+		CArrayPushBack(&c->DirtyTiles, &tile);
+	}
+}
+
+static color_t TileColor(Map *map, const Vec2i pos, const bool showAll)
+{
+	const Tile *tile = MapGetTile(map, pos);
+	color_t color = { 0, 0, 0, 0 };
+	if (!(tile->flags & MAPTILE_IS_NOTHING) && (tile->isVisited || showAll))
+	{
+		color = colorRoom;
+		if (tile->flags & MAPTILE_IS_WALL)
+		{
+			color = colorWall;
+		}
+		else if (tile->flags & MAPTILE_NO_WALK)
+		{
+			color = DoorColor(pos.x, pos.y);
+		}
+		else if (tile->flags & MAPTILE_IS_NORMAL_FLOOR)
+		{
+			color = colorFloor;
+		}
+	}
+	return color;
+}
+static AutomapCache *UpdateCache(Map *map, const bool showAll)
+{
+	AutomapCache *c = &sCaches[showAll ? 1 : 0];
+	if (c->Map != map || !Vec2iEqual(c->Size, map->Size))
+	{
+		c->IsDirty = true;
+	}
+	if (c->IsDirty)
+	{
+		if (c->Colors.elemSize == 0)
+		{
+			CArrayInit(&c->Colors, sizeof(color_t));
+		}
+		CArrayResize(&c->Colors, map->Size.x * map->Size.y, NULL);
+		color_t *color = c->Colors.data;
+		Vec2i v;
+		for (v.y = 0; v.y < map->Size.y; v.y++)
+		{
+			for (v.x = 0; v.x < map->Size.x; v.x++, color++)
+			{
+				*color = TileColor(map, v, showAll);
+			}
+		}
+		c->Map = map;
+		c->Size = map->Size;
+		c->IsDirty = false;
+	}
+	else
+	{
+		CA_FOREACH(const Vec2i, v, c->DirtyTiles)
+			if (MapIsTileIn(map, *v))
+			{
+				*(color_t *)CArrayGet(
+					&c->Colors, v->y * map->Size.x + v->x) =
+					TileColor(map, *v, showAll);
+			}
+		CA_FOREACH_END()
+	}
+	if (c->DirtyTiles.elemSize != 0)
+	{
+		CArrayClear(&c->DirtyTiles);
+	}
+	return c;
+}
+
 static void DrawMap(
 	Map *map,
 	Vec2i center, Vec2i centerOn, Vec2i size,
 	int scale, int flags)
 {
-	int x, y;
-	Vec2i mapPos = Vec2iAdd(center, Vec2iScale(centerOn, -scale));
-	for (y = 0; y < gMap.Size.y; y++)
+	const AutomapCache *cache =
+		UpdateCache(map, !!(flags & AUTOMAP_FLAGS_SHOWALL));
+	const Vec2i mapPos = Vec2iAdd(center, Vec2iScale(centerOn, -scale));
+	const BlitClipping *clip = &gGraphicsDevice.clipping;
+	const int w = gGraphicsDevice.cachedConfig.Res.x;
+	Uint32 *screen = gGraphicsDevice.buf;
+	// Only visit the tiles that overlap the clipping area, and clip each
+	// tile once rather than every pixel
+	const int xStart = MAX(0, (clip->left - mapPos.x) / scale);
+	const int xEnd = MIN(map->Size.x - 1, (clip->right - mapPos.x) / scale);
+	const int yStart = MAX(0, (clip->top - mapPos.y) / scale);
+	const int yEnd = MIN(map->Size.y - 1, (clip->bottom - mapPos.y) / scale);
+	for (int y = yStart; y <= yEnd; y++)
 	{
-		int i;
-		for (i = 0; i < scale; i++)
+		const int top = MAX(clip->top, mapPos.y + y * scale);
+		const int bottom = MIN(clip->bottom, mapPos.y + y * scale + scale - 1);
+		const color_t *colors =
+			(const color_t *)cache->Colors.data + y * map->Size.x;
+		for (int x = xStart; x <= xEnd; x++)
 		{
-			for (x = 0; x < gMap.Size.x; x++)
+			color_t color = colors[x];
+			if (color.a == 0)
+			{
+				continue;
+			}
+			if (flags & AUTOMAP_FLAGS_MASK)
 			{
-				Tile *tile = MapGetTile(map, Vec2iNew(x, y));
-				if (!(tile->flags & MAPTILE_IS_NOTHING) &&
-					(tile->isVisited || (flags & AUTOMAP_FLAGS_SHOWALL)))
+				color.a = MASK_ALPHA;
+			}
+			const Uint32 pixel = COLOR2PIXEL(color);
+			const int left = MAX(clip->left, mapPos.x + x * scale);
+			const int right =
+				MIN(clip->right, mapPos.x + x * scale + scale - 1);
+			for (int py = top; py <= bottom; py++)
+			{
+				Uint32 *p = screen + py * w + left;
+				for (int px = left; px <= right; px++, p++)
 				{
-					int j;
-					for (j = 0; j < scale; j++)
+					if (color.a == 255)
+					{
+						*p = pixel;
+					}
+					else
 					{
-						Vec2i drawPos = Vec2iNew(
-							mapPos.x + x*scale + j,
-							mapPos.y + y*scale + i);
-						color_t color = colorRoom;
-						if (tile->flags & MAPTILE_IS_WALL)
-						{
-							color = colorWall;
-						}
-						else if (tile->flags & MAPTILE_NO_WALK)
-						{
-							color = DoorColor(x, y);
-						}
-						else if (tile->flags & MAPTILE_IS_NORMAL_FLOOR)
-						{
-							color = colorFloor;
-						}
-						if (!ColorEquals(color, colorBlack))
-						{
-							if (flags & AUTOMAP_FLAGS_MASK)
-							{
-								color.a = MASK_ALPHA;
-							}
-							Draw_Point(drawPos.x, drawPos.y, color);
-						}
+						*p = COLOR2PIXEL(
+							ColorAlphaBlend(PIXEL2COLOR(*p), color));
 					}
 				}
 			}
@@ -268,10 +392,9 @@ static void DrawObjectivesAndKeys(Map *map, Vec2i pos, int scale, int flags)
 		for (int x = 0; x < map->Size.x; x++)
 		{
 			Tile *tile = MapGetTile(map, Vec2iNew(x, y));
-			CA_FOREACH(ThingId, tid, tile->things)
-				DrawTileItem(
-					ThingIdGetTileItem(tid), tile, pos, scale, flags);
-			CA_FOREACH_END()
+			TILE_FOREACH_THING(tile, ti)
+				DrawTileItem(ti, tile, pos, scale, flags);
+			TILE_FOREACH_THING_END()
 		}
 	}
 }
@@ -35,6 +35,11 @@
 #define AUTOMAP_FLAGS_SHOWALL 0x01
 #define AUTOMAP_FLAGS_MASK 0x02
 
+// The explored map is cached as one colour per tile
+// Invalidate when tiles change or are explored, or when a new map is loaded
+void AutomapInvalidate(void);
+void AutomapInvalidateTile(const Vec2i tile);
+
 void AutomapDraw(int flags, bool showExit);
 void AutomapDrawRegion(
 	Map *map,
@@ -125,11 +125,34 @@ void BlitPicHighlight(
 	}
 }
 
+// Tables for the most recently used tints
+#define TINT_TABLES 4
+static ColorTintTable sTintTables[TINT_TABLES];
+static int sTintTablesCount = 0;
+static int sTintTablesNext = 0;
+static const ColorTintTable *GetTintTable(const HSV tint)
+{
+	for (int i = 0; i < sTintTablesCount; i++)
+	{
+		const HSV t = sTintTables[i].Tint;
+		if (t.h == tint.h && t.s == tint.s && t.v == tint.v)
+		{
+			return &sTintTables[i];
+		}
+	}
+	ColorTintTable *t = &sTintTables[sTintTablesNext];
+	ColorTintTableInit(t, tint);
+	sTintTablesNext = (sTintTablesNext + 1) % TINT_TABLES;
+	sTintTablesCount = MIN(sTintTablesCount + 1, TINT_TABLES);
+	return t;
+}
+
 void BlitBackground(
 	GraphicsDevice *device,
 	const Pic *pic, Vec2i pos, const HSV *tint, const bool isTransparent)
 {
 	Uint32 *current = pic->Data;
+	const ColorTintTable *tintTable = tint != NULL ? GetTintTable(*tint) : NULL;
 	pos = Vec2iAdd(pos, pic->offset);
 	for (int i = 0; i < pic->size.y; i++)
 	{
@@ -160,10 +183,11 @@ void BlitBackground(
 			if ((isTransparent && *current) ||  !isTransparent)
 			{
 				Uint32 *target = gGraphicsDevice.buf + yoff + xoff;
-				if (tint != NULL)
+				if (tintTable != NULL)
 				{
 					const color_t targetColor = PIXEL2COLOR(*target);
-					const color_t blendedColor = ColorTint(targetColor, *tint);
+					const color_t blendedColor =
+						ColorTintTableApply(tintTable, targetColor);
 					*target = COLOR2PIXEL(blendedColor);
 				}
 				else
@@ -177,17 +201,23 @@ void BlitBackground(
 }
 
 void Blit(GraphicsDevice *device, const Pic *pic, Vec2i pos)
+{
+	BlitClipped(device, pic, pos, &device->clipping);
+}
+void BlitClipped(
+	GraphicsDevice *device, const Pic *pic, Vec2i pos,
+	const BlitClipping *clip)
 {
 	Uint32 *current = pic->Data;
 	pos = Vec2iAdd(pos, pic->offset);
 	for (int i = 0; i < pic->size.y; i++)
 	{
 		int yoff = i + pos.y;
-		if (yoff > device->clipping.bottom)
+		if (yoff > clip->bottom)
 		{
 			break;
 		}
-		if (yoff < device->clipping.top)
+		if (yoff < clip->top)
 		{
 			current += pic->size.x;
 			continue;
@@ -197,12 +227,12 @@ void Blit(GraphicsDevice *device, const Pic *pic, Vec2i pos)
 		{
 			Uint32 *target;
 			int xoff = j + pos.x;
-			if (xoff < device->clipping.left)
+			if (xoff < clip->left)
 			{
 				current++;
 				continue;
 			}
-			if (xoff > device->clipping.right)
+			if (xoff > clip->right)
 			{
 				current += pic->size.x - j;
 				break;
@@ -400,20 +430,33 @@ void BlitBlend(
 static void RenderTexture(SDL_Renderer *r, SDL_Texture *t);
 void BlitFlip(GraphicsDevice *g)
 {
-	SDL_UpdateTexture(
-		g->screen, NULL, g->buf, g->cachedConfig.Res.x * sizeof(Uint32));
+	// The static background is already merged into the frame by
+	// GraphicsClear, so the screen is the only full-frame layer
+	if (g->screenLocked)
+	{
+		GraphicsUnlockScreen(g);
+	}
+	else
+	{
+		SDL_UpdateTexture(
+			g->screen, NULL, g->buf, g->cachedConfig.Res.x * sizeof(Uint32));
+	}
 	if (SDL_RenderClear(g->renderer) != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Failed to clear renderer: %s\n",
 			SDL_GetError());
+		GraphicsLockScreen(g);
 		return;
 	}
-	RenderTexture(g->renderer, g->bkg);
 	RenderTexture(g->renderer, g->screen);
 	// Apply brightness as an overlay texture
-	RenderTexture(g->renderer, g->brightnessOverlay);
+	if (g->brightnessOverlay != NULL)
+	{
+		RenderTexture(g->renderer, g->brightnessOverlay);
+	}
 
 	SDL_RenderPresent(g->renderer);
+	GraphicsLockScreen(g);
 }
 static void RenderTexture(SDL_Renderer *r, SDL_Texture *t)
 {
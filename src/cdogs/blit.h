@@ -77,6 +77,11 @@ void BlitBackground(
 	GraphicsDevice *device,
 	const Pic *pic, Vec2i pos, const HSV *tint, const bool isTransparent);
 void Blit(GraphicsDevice *device, const Pic *pic, Vec2i pos);
+// Blit with an explicit clip area instead of the device's, so that
+// concurrent jobs can each draw to their own part of the screen
+void BlitClipped(
+	GraphicsDevice *device, const Pic *pic, Vec2i pos,
+	const BlitClipping *clip);
 void BlitMasked(
 	GraphicsDevice *device,
 	const Pic *pic,
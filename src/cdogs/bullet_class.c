@@ -166,7 +166,7 @@ bool UpdateBullet(struct MobileObject *obj, const int ticks)
 			s.u.AddParticle.Class = obj->bulletClass->OutOfRangeSpark;
 			s.u.AddParticle.FullPos = Vec2iNew(obj->x, obj->y);
 			s.u.AddParticle.Z = obj->z;
-			GameEventsEnqueue(&gGameEvents, s);
+			GameEventsEnqueue(&gGameEvents, &s);
 		}
 		return false;
 	}
@@ -233,7 +233,7 @@ bool UpdateBullet(struct MobileObject *obj, const int ticks)
 			b.u.BulletBounce.Pos = Vec2i2Net(pos);
 			b.u.BulletBounce.Vel = Vec2i2Net(obj->tileItem.VelFull);
 		}
-		GameEventsEnqueue(&gGameEvents, b);
+		GameEventsEnqueue(&gGameEvents, &b);
 		if (!alive)
 		{
 			return false;
@@ -847,27 +847,8 @@ void BulletAdd(const NAddBullet add)
 {
 	const Vec2i pos = Net2Vec2i(add.MuzzlePos);
 
-	// Find an empty slot in mobobj list
-	TMobileObject *obj = NULL;
-	int i;
-	for (i = 0; i < (int)gMobObjs.size; i++)
-	{
-		TMobileObject *m = CArrayGet(&gMobObjs, i);
-		if (!m->isInUse)
-		{
-			obj = m;
-			break;
-		}
-	}
-	if (obj == NULL)
-	{
-		TMobileObject m;
-		memset(&m, 0, sizeof m);
-		CArrayPushBack(&gMobObjs, &m);
-		i = (int)gMobObjs.size - 1;
-		obj = CArrayGet(&gMobObjs, i);
-	}
-	memset(obj, 0, sizeof *obj);
+	const int i = MobObjAlloc();
+	TMobileObject *obj = CArrayGet(&gMobObjs, i);
 	obj->UID = add.UID;
 	obj->bulletClass = StrBulletClass(add.BulletClass);
 	obj->x = pos.x;
@@ -31,6 +31,7 @@
 #include "draw/drawtools.h"
 #include "events.h"
 #include "font.h"
+#include "grafx_bg.h"
 #include "los.h"
 #include "player.h"
 
@@ -128,9 +129,7 @@ void CameraDraw(
 	const int h = gGraphicsDevice.cachedConfig.Res.y;
 
 	// clear screen
-	memset(
-		gGraphicsDevice.buf, 0,
-		GraphicsGetMemSize(&gGraphicsDevice.cachedConfig));
+	GraphicsClear(&gGraphicsDevice);
 
 	const Vec2i noise = ScreenShakeGetDelta(camera->shake);
 
@@ -32,6 +32,7 @@
 
 #include <tinydir/tinydir.h>
 
+#include <cdogs/draw/actor_pic_cache.h>
 #include <cdogs/files.h>
 #include <cdogs/log.h>
 #include <cdogs/map_new.h>
@@ -72,6 +73,8 @@ void CampaignSettingTerminate(CampaignSetting *setting)
 	// Unload previous custom data
 	SoundClear(gSoundDevice.customSounds);
 	PicManagerClearCustom(&gPicManager);
+	// Composited actor pics may refer to the unloaded pics
+	ActorPicCacheClear(&gActorPicCache);
 	ParticleClassesClear(&gParticleClasses.CustomClasses);
 	AmmoClassesClear(&gAmmo.CustomAmmo);
 	CharacterClassesClear(&gCharacterClasses.CustomClasses);
@@ -31,6 +31,7 @@
 #include <assert.h>
 
 #include "actors.h"
+#include "file_writer.h"
 #include "files.h"
 #include "json_utils.h"
 
@@ -148,12 +149,11 @@ void CharacterLoadJSON(CharacterStore *c, json_t *root, int version)
 	}
 }
 
-bool CharacterSave(CharacterStore *s, const char *path)
+void CharacterSave(CharacterStore *s, const char *path)
 {
 	json_t *root = json_new_object();
 	AddIntPair(root, "Version", CHARACTER_VERSION);
-	bool res = true;
-	
+
 	json_t *charNode = json_new_array();
 	CA_FOREACH(Character, c, s->OtherChars)
 		json_t *node = json_new_object();
@@ -177,15 +177,7 @@ bool CharacterSave(CharacterStore *s, const char *path)
 	json_insert_pair_into_object(root, "Characters", charNode);
 	char buf[CDOGS_PATH_MAX];
 	sprintf(buf, "%s/characters.json", path);
-	if (!TrySaveJSONFile(root, buf))
-	{
-		res = false;
-		goto bail;
-	}
-
-bail:
-	json_free_value(&root);
-	return res;
+	FileWriterSaveJSON(&gFileWriter, buf, root);
 }
 
 Character *CharacterStoreAddOther(CharacterStore *store)
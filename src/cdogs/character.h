@@ -65,7 +65,8 @@ void CharacterStoreInit(CharacterStore *store);
 void CharacterStoreTerminate(CharacterStore *store);
 void CharacterStoreResetOthers(CharacterStore *store);
 void CharacterLoadJSON(CharacterStore *c, json_t *root, int version);
-bool CharacterSave(CharacterStore *s, const char *path);
+// Queued on gFileWriter; flush it to find out whether it was written
+void CharacterSave(CharacterStore *s, const char *path);
 Character *CharacterStoreAddOther(CharacterStore *store);
 Character *CharacterStoreInsertOther(CharacterStore *store, int idx);
 void CharacterStoreDeleteOther(CharacterStore *store, int idx);
@@ -49,7 +49,6 @@
 #include "collision.h"
 
 #include "actors.h"
-#include "algorithms.h"
 #include "config.h"
 #include "minkowski_hex.h"
 #include "objs.h"
@@ -287,7 +286,7 @@ static bool CollisionIsOnSameTeam(
 static bool CheckParams(
 	const CollisionParams params, const TTileItem *a, const TTileItem *b);
 
-static void AddPosToTileCache(void *data, Vec2i pos);
+static void TileCacheAddLine(CArray *tc, const Vec2i from, const Vec2i to);
 static bool CheckOverlaps(
 	const TTileItem *item, const Vec2i pos, const Vec2i vel, const Vec2i size,
 	const CollisionParams params, CollideItemFunc func, void *data,
@@ -300,12 +299,10 @@ void OverlapTileItems(
 {
 	TileCacheReset(&gCollisionSystem.tileCache);
 	// Add all the tiles along the motion path
-	AlgoLineDrawData drawData;
-	drawData.Draw = AddPosToTileCache;
-	drawData.data = &gCollisionSystem.tileCache;
 	const Vec2i posReal = Vec2iFull2Real(pos);
 	const Vec2i vel = Vec2iFull2Real(item->VelFull);
-	BresenhamLineDraw(posReal, Vec2iAdd(posReal, vel), &drawData);
+	TileCacheAddLine(
+		&gCollisionSystem.tileCache, posReal, Vec2iAdd(posReal, vel));
 
 	// Check collisions with all tiles in the cache
 	CA_FOREACH(const Vec2i, dtv, gCollisionSystem.tileCache)
@@ -318,11 +315,48 @@ void OverlapTileItems(
 		}
 	CA_FOREACH_END()
 }
-static void AddPosToTileCache(void *data, Vec2i pos)
+// Walk the tiles crossed by a line, one tile at a time (DDA).
+// Fast movers such as bullets cross several pixels per tile, so this visits
+// far fewer tiles than drawing the line pixel by pixel.
+static double DDAFirstEdge(
+	const int from, const int d, const int tile, const int tileSize);
+static void TileCacheAddLine(CArray *tc, const Vec2i from, const Vec2i to)
 {
-	CArray *tileCache = data;
-	const Vec2i tv = Vec2iToTile(pos);
-	TileCacheAdd(tileCache, tv);
+	Vec2i tv = Vec2iToTile(from);
+	const Vec2i tvEnd = Vec2iToTile(to);
+	TileCacheAdd(tc, tv);
+	const Vec2i d = Vec2iMinus(to, from);
+	const Vec2i step = Vec2iNew(d.x > 0 ? 1 : -1, d.y > 0 ? 1 : -1);
+	// Fraction of the line travelled when crossing the next x/y tile edge,
+	// and between successive x/y tile edges
+	double tMaxX = DDAFirstEdge(from.x, d.x, tv.x, TILE_WIDTH);
+	double tMaxY = DDAFirstEdge(from.y, d.y, tv.y, TILE_HEIGHT);
+	const double tDeltaX = d.x == 0 ? 0 : (double)TILE_WIDTH / abs(d.x);
+	const double tDeltaY = d.y == 0 ? 0 : (double)TILE_HEIGHT / abs(d.y);
+	for (int n = abs(tvEnd.x - tv.x) + abs(tvEnd.y - tv.y); n > 0; n--)
+	{
+		if (tv.y == tvEnd.y || (tv.x != tvEnd.x && tMaxX < tMaxY))
+		{
+			tv.x += step.x;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			tv.y += step.y;
+			tMaxY += tDeltaY;
+		}
+		TileCacheAdd(tc, tv);
+	}
+}
+static double DDAFirstEdge(
+	const int from, const int d, const int tile, const int tileSize)
+{
+	if (d == 0)
+	{
+		return 2;
+	}
+	const int edge = d > 0 ? (tile + 1) * tileSize : tile * tileSize;
+	return (double)(edge - from) / d;
 }
 static bool CheckOverlaps(
 	const TTileItem *item, const Vec2i pos, const Vec2i vel, const Vec2i size,
@@ -334,9 +368,7 @@ static bool CheckOverlaps(
 	// Check item collisions
 	if (func != NULL)
 	{
-		const CArray *tileThings = &MapGetTile(&gMap, tilePos)->things;
-		CA_FOREACH(const ThingId, tid, *tileThings)
-			TTileItem *ti = ThingIdGetTileItem(tid);
+		TILE_FOREACH_THING(MapGetTile(&gMap, tilePos), ti)
 			if (!CheckParams(params, item, ti))
 			{
 				continue;
@@ -353,7 +385,7 @@ static bool CheckOverlaps(
 			{
 				return false;
 			}
-		CA_FOREACH_END()
+		TILE_FOREACH_THING_END()
 	}
 	// Check wall collisions
 	if (checkWallFunc != NULL && wallFunc != NULL && checkWallFunc(tilePos))
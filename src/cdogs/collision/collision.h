@@ -64,8 +64,8 @@ void CollisionSystemInit(CollisionSystem *cs);
 void CollisionSystemReset(CollisionSystem *cs);
 void CollisionSystemTerminate(CollisionSystem *cs);
 
-#define HitWall(x, y) (MapGetTile(&gMap, Vec2iNew((x)/TILE_WIDTH, (y)/TILE_HEIGHT))->flags & MAPTILE_NO_WALK)
-#define ShootWall(x, y) (MapGetTile(&gMap, Vec2iNew((x)/TILE_WIDTH, (y)/TILE_HEIGHT))->flags & MAPTILE_NO_SHOOT)
+#define HitWall(x, y) (MapGetTileFlags(&gMap, Vec2iNew((x)/TILE_WIDTH, (y)/TILE_HEIGHT)) & MAPTILE_NO_WALK)
+#define ShootWall(x, y) (MapGetTileFlags(&gMap, Vec2iNew((x)/TILE_WIDTH, (y)/TILE_HEIGHT)) & MAPTILE_NO_SHOOT)
 
 // Which "team" the actor's on, for collision
 // Actors on the same team don't have to collide
@@ -191,6 +191,44 @@ color_t ColorTint(color_t c, HSV hsv)
 	return out;
 }
 
+void ColorTintTableInit(ColorTintTable *t, const HSV tint)
+{
+	t->Tint = tint;
+	t->ByAvgOnly = tint.s <= 0.0 || tint.h >= 0;
+	for (int i = 0; i < 256; i++)
+	{
+		if (t->ByAvgOnly)
+		{
+			const color_t gray = { (uint8_t)i, (uint8_t)i, (uint8_t)i, 255 };
+			t->ByAvg[i] = ColorTint(gray, tint);
+		}
+		else
+		{
+			t->AvgPart[i] = i * (1.0 - tint.s);
+			t->CompPart[i] = tint.s * i;
+		}
+	}
+}
+color_t ColorTintTableApply(const ColorTintTable *t, const color_t c)
+{
+	const int vAvg = ((int)c.r + c.g + c.b) / 3;
+	color_t out;
+	if (t->ByAvgOnly)
+	{
+		out = t->ByAvg[vAvg];
+	}
+	else
+	{
+		const double v = t->Tint.v;
+		const double avgPart = t->AvgPart[vAvg];
+		out.r = (uint8_t)CLAMP(v * (avgPart + t->CompPart[c.r]), 0, 255);
+		out.g = (uint8_t)CLAMP(v * (avgPart + t->CompPart[c.g]), 0, 255);
+		out.b = (uint8_t)CLAMP(v * (avgPart + t->CompPart[c.b]), 0, 255);
+	}
+	out.a = c.a;
+	return out;
+}
+
 bool ColorEquals(const color_t a, const color_t b)
 {
 	return a.r == b.r && a.g == b.g && a.b == b.b;
@@ -110,6 +110,22 @@ extern HSV tintDarker;
 // v: scale factor on the final components
 color_t ColorTint(color_t c, HSV hsv);
 
+// Precomputed ColorTint for one tint, for tinting many pixels
+// Gives the same results as ColorTint
+typedef struct
+{
+	HSV Tint;
+	// If the tint sets the hue or removes saturation, the result only
+	// depends on the average of the RGB components
+	bool ByAvgOnly;
+	color_t ByAvg[256];
+	// Otherwise each component is v * (AvgPart[avg] + CompPart[component])
+	double AvgPart[256];
+	double CompPart[256];
+} ColorTintTable;
+void ColorTintTableInit(ColorTintTable *t, const HSV tint);
+color_t ColorTintTableApply(const ColorTintTable *t, const color_t c);
+
 bool ColorEquals(const color_t a, const color_t b);
 bool HSVEquals(const HSV a, const HSV b);
 
@@ -731,6 +731,12 @@ Config ConfigDefault(void)
 		QUICKPLAY_QUANTITY_ANY, QUICKPLAY_QUANTITY_LARGE,
 		StrQuickPlayQuantity, QuickPlayQuantityStr));
 	ConfigGroupAdd(&root, qp);
+
+	Config ed = ConfigNewGroup("Editor");
+	// Memory for the undo history, in megabytes
+	ConfigGroupAdd(&ed,
+		ConfigNewInt("UndoMemory", 32, 1, 1024, 1, NULL, NULL));
+	ConfigGroupAdd(&root, ed);
 	
 	ConfigGroupAdd(&root, ConfigNewBool("StartServer", false));
 
@@ -33,6 +33,7 @@
 #include <json/json.h>
 
 #include "config.h"
+#include "file_writer.h"
 #include "json_utils.h"
 #include "keyboard.h"
 #include "log.h"
@@ -171,31 +172,12 @@ static void ConfigLoadVisit(Config *c, json_t *node)
 static void ConfigSaveVisit(const Config *c, json_t *node);
 void ConfigSaveJSON(const Config *config, const char *filename)
 {
-	FILE *f = fopen(filename, "w");
-	char *text = NULL;
-	json_t *root;
-
-	if (f == NULL)
-	{
-		printf("Error saving config '%s'\n", filename);
-		return;
-	}
-
-	root = json_new_object();
+	json_t *root = json_new_object();
 	json_insert_pair_into_object(
 		root, "Version", json_new_number(TOSTRING(CONFIG_VERSION)));
 	ConfigSaveVisit(config, root);
 
-	json_tree_to_string(root, &text);
-	char *formatText = json_format_string(text);
-	fputs(formatText, f);
-
-	// clean up
-	CFREE(formatText);
-	CFREE(text);
-	json_free_value(&root);
-
-	fclose(f);
+	FileWriterSaveJSON(&gFileWriter, filename, root);
 }
 static void ConfigSaveVisit(const Config *c, json_t *node)
 {
@@ -50,6 +50,29 @@ void NamedPicFree(NamedPic *n)
 {
 	PicFree(&n->pic);
 	CFREE(n->name);
+	if (n->fogged != NULL)
+	{
+		PicFree(n->fogged);
+		CFREE(n->fogged);
+	}
+}
+const Pic *NamedPicGetFogged(NamedPic *n)
+{
+	if (n->fogged == NULL)
+	{
+		// Same result as BlitMasked with fog, without transparency
+		CMALLOC(n->fogged, sizeof *n->fogged);
+		*n->fogged = n->pic;
+		const int size = n->pic.size.x * n->pic.size.y;
+		CMALLOC(n->fogged->Data, size * sizeof *n->fogged->Data);
+		const Uint32 fogPixel = COLOR2PIXEL(colorFog);
+		for (int i = 0; i < size; i++)
+		{
+			n->fogged->Data[i] = PixelMult(n->pic.Data[i], fogPixel) |
+				gGraphicsDevice.Format->Amask;
+		}
+	}
+	return n->fogged;
 }
 
 
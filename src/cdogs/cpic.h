@@ -37,6 +37,8 @@ typedef struct
 {
 	Pic pic;
 	char *name;
+	// Copy of the pic masked by fog; created on first use
+	Pic *fogged;
 } NamedPic;
 typedef struct
 {
@@ -84,6 +86,7 @@ typedef struct
 typedef CPicDrawContext (*GetDrawContextFunc)(const int);
 
 void NamedPicFree(NamedPic *n);
+const Pic *NamedPicGetFogged(NamedPic *n);
 
 void NamedSpritesInit(NamedSprites *ns, const char *name);
 void NamedSpritesFree(NamedSprites *ns);
@@ -0,0 +1,363 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "actor_pic_cache.h"
+
+#include <string.h>
+
+
+typedef struct
+{
+	const Pic *Pics[BODY_PART_COUNT];
+	Vec2i Offsets[BODY_PART_COUNT];
+	CharColors Colors;
+} ActorPicCacheKey;
+typedef struct
+{
+	ActorPicCacheKey Key;
+	Uint32 Hash;
+	// Next entry in the same hash bucket, or -1
+	int HashNext;
+	// Neighbours in the use order, or -1
+	int Newer;
+	int Older;
+	Pic Pic;
+} ActorPicCacheEntry;
+typedef struct
+{
+	const CharSprites *CharSprites;
+	int Variant;
+	const NamedSprites *Sprites;
+} ActorSpritesCacheEntry;
+
+
+// Initial number of hash buckets; always a power of two
+#define ACTOR_PIC_CACHE_BUCKETS 64
+
+
+ActorPicCache gActorPicCache;
+
+void ActorPicCacheInit(ActorPicCache *c, const size_t maxMemory)
+{
+	memset(c, 0, sizeof *c);
+	CArrayInit(&c->Entries, sizeof(ActorPicCacheEntry));
+	CArrayInit(&c->Buckets, sizeof(int));
+	const int none = -1;
+	CArrayResize(&c->Buckets, ACTOR_PIC_CACHE_BUCKETS, &none);
+	c->Newest = -1;
+	c->Oldest = -1;
+	CArrayInit(&c->Sprites, sizeof(ActorSpritesCacheEntry));
+	c->MaxMemory = maxMemory;
+}
+void ActorPicCacheTerminate(ActorPicCache *c)
+{
+	ActorPicCacheClear(c);
+	CArrayTerminate(&c->Entries);
+	CArrayTerminate(&c->Buckets);
+	CArrayTerminate(&c->Sprites);
+}
+void ActorPicCacheClear(ActorPicCache *c)
+{
+	CA_FOREACH(ActorPicCacheEntry, e, c->Entries)
+		PicFree(&e->Pic);
+	CA_FOREACH_END()
+	CArrayClear(&c->Entries);
+	CA_FOREACH(int, bucket, c->Buckets)
+		*bucket = -1;
+	CA_FOREACH_END()
+	c->Newest = -1;
+	c->Oldest = -1;
+	c->Memory = 0;
+	CArrayClear(&c->Sprites);
+}
+
+static ActorPicCacheEntry *GetEntry(const ActorPicCache *c, const int idx)
+{
+	return CArrayGet(&c->Entries, idx);
+}
+static int *GetBucket(const ActorPicCache *c, const Uint32 hash)
+{
+	return CArrayGet(&c->Buckets, (int)(hash & (c->Buckets.size - 1)));
+}
+// Find the link to the entry in its hash bucket
+static int *FindHashLink(const ActorPicCache *c, const int idx)
+{
+	int *link = GetBucket(c, GetEntry(c, idx)->Hash);
+	while (*link != idx)
+	{
+		link = &GetEntry(c, *link)->HashNext;
+	}
+	return link;
+}
+static void Rehash(ActorPicCache *c, const int numBuckets)
+{
+	const int none = -1;
+	CArrayClear(&c->Buckets);
+	CArrayResize(&c->Buckets, numBuckets, &none);
+	CA_FOREACH(ActorPicCacheEntry, e, c->Entries)
+		int *bucket = GetBucket(c, e->Hash);
+		e->HashNext = *bucket;
+		*bucket = _ca_index;
+	CA_FOREACH_END()
+}
+static void UseOrderRemove(ActorPicCache *c, const int idx)
+{
+	const ActorPicCacheEntry *e = GetEntry(c, idx);
+	if (e->Newer >= 0)
+	{
+		GetEntry(c, e->Newer)->Older = e->Older;
+	}
+	else
+	{
+		c->Newest = e->Older;
+	}
+	if (e->Older >= 0)
+	{
+		GetEntry(c, e->Older)->Newer = e->Newer;
+	}
+	else
+	{
+		c->Oldest = e->Newer;
+	}
+}
+static void UseOrderAddNewest(ActorPicCache *c, const int idx)
+{
+	ActorPicCacheEntry *e = GetEntry(c, idx);
+	e->Newer = -1;
+	e->Older = c->Newest;
+	if (c->Newest >= 0)
+	{
+		GetEntry(c, c->Newest)->Newer = idx;
+	}
+	else
+	{
+		c->Oldest = idx;
+	}
+	c->Newest = idx;
+}
+
+static Uint32 KeyHash(const ActorPicCacheKey *k);
+static Pic Composite(const ActorPicCacheKey *k);
+static void EvictLeastRecentlyUsed(ActorPicCache *c);
+const Pic *ActorPicCacheGet(
+	ActorPicCache *c, const Pic *const pics[BODY_PART_COUNT],
+	const Vec2i offsets[BODY_PART_COUNT], const CharColors *colors)
+{
+	if (c->Entries.elemSize == 0)
+	{
+		return NULL;
+	}
+	// Zero the key so that the padding bytes compare equal too
+	ActorPicCacheKey key;
+	memset(&key, 0, sizeof key);
+	for (int i = 0; i < BODY_PART_COUNT; i++)
+	{
+		key.Pics[i] = pics[i];
+		if (pics[i] != NULL)
+		{
+			key.Offsets[i] = offsets[i];
+		}
+	}
+	key.Colors = *colors;
+	const Uint32 hash = KeyHash(&key);
+
+	for (int i = *GetBucket(c, hash); i >= 0; i = GetEntry(c, i)->HashNext)
+	{
+		const ActorPicCacheEntry *e = GetEntry(c, i);
+		if (e->Hash == hash && memcmp(&e->Key, &key, sizeof key) == 0)
+		{
+			if (c->Newest != i)
+			{
+				UseOrderRemove(c, i);
+				UseOrderAddNewest(c, i);
+			}
+			return &e->Pic;
+		}
+	}
+
+	ActorPicCacheEntry e;
+	e.Key = key;
+	e.Hash = hash;
+	e.Pic = Composite(&key);
+	const size_t size = e.Pic.size.x * e.Pic.size.y * sizeof *e.Pic.Data;
+	while (c->Entries.size > 0 && c->Memory + size > c->MaxMemory)
+	{
+		EvictLeastRecentlyUsed(c);
+	}
+	int *bucket = GetBucket(c, hash);
+	e.HashNext = *bucket;
+	const int idx = (int)c->Entries.size;
+	*bucket = idx;
+	CArrayPushBack(&c->Entries, &e);
+	UseOrderAddNewest(c, idx);
+	c->Memory += size;
+	// Keep the buckets short
+	if (c->Entries.size > c->Buckets.size)
+	{
+		Rehash(c, (int)c->Buckets.size * 2);
+	}
+	return &GetEntry(c, idx)->Pic;
+}
+static Uint32 KeyHash(const ActorPicCacheKey *k)
+{
+	// FNV-1a
+	Uint32 hash = 2166136261u;
+	const unsigned char *p = (const unsigned char *)k;
+	for (size_t i = 0; i < sizeof *k; i++)
+	{
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+static Pic Composite(const ActorPicCacheKey *k)
+{
+	// Find the bounds of all the parts
+	Vec2i min = Vec2iZero();
+	Vec2i max = Vec2iZero();
+	bool first = true;
+	for (int i = 0; i < BODY_PART_COUNT; i++)
+	{
+		const Pic *pic = k->Pics[i];
+		if (pic == NULL)
+		{
+			continue;
+		}
+		const Vec2i partMin = Vec2iAdd(k->Offsets[i], pic->offset);
+		const Vec2i partMax = Vec2iAdd(partMin, pic->size);
+		min = first ? partMin : Vec2iMin(min, partMin);
+		max = first ? partMax : Vec2iMax(max, partMax);
+		first = false;
+	}
+
+	Pic p;
+	p.offset = min;
+	p.size = Vec2iMinus(max, min);
+	p.Data = NULL;
+	if (p.size.x == 0 || p.size.y == 0)
+	{
+		return p;
+	}
+	CCALLOC(p.Data, p.size.x * p.size.y * sizeof *p.Data);
+
+	// Draw the parts in order, the same as BlitCharMultichannel
+	const Uint32 amask = gGraphicsDevice.Format->Amask;
+	for (int i = 0; i < BODY_PART_COUNT; i++)
+	{
+		const Pic *pic = k->Pics[i];
+		if (pic == NULL)
+		{
+			continue;
+		}
+		const Vec2i pos = Vec2iMinus(
+			Vec2iAdd(k->Offsets[i], pic->offset), min);
+		const Uint32 *current = pic->Data;
+		for (int y = 0; y < pic->size.y; y++)
+		{
+			Uint32 *target = p.Data + (pos.y + y) * p.size.x + pos.x;
+			for (int x = 0; x < pic->size.x; x++, current++, target++)
+			{
+				if (*current == 0)
+				{
+					continue;
+				}
+				const color_t color = PIXEL2COLOR(*current);
+				*target = PixelMult(
+					*current,
+					COLOR2PIXEL(CharColorsGetChannelMask(&k->Colors, color.a)));
+				// The composite is drawn with Blit, which skips
+				// transparent pixels; make sure drawn pixels are opaque
+				if ((*target & amask) == 0)
+				{
+					*target |= amask;
+				}
+			}
+		}
+	}
+	return p;
+}
+static void EvictLeastRecentlyUsed(ActorPicCache *c)
+{
+	const int lruIndex = c->Oldest;
+	ActorPicCacheEntry *e = GetEntry(c, lruIndex);
+	c->Memory -= e->Pic.size.x * e->Pic.size.y * sizeof *e->Pic.Data;
+	PicFree(&e->Pic);
+	UseOrderRemove(c, lruIndex);
+	*FindHashLink(c, lruIndex) = e->HashNext;
+	// Order doesn't matter; move the last entry in, and point its links
+	// at the new index
+	const int last = (int)c->Entries.size - 1;
+	if (lruIndex != last)
+	{
+		const ActorPicCacheEntry *moved = GetEntry(c, last);
+		*FindHashLink(c, last) = lruIndex;
+		if (moved->Newer >= 0)
+		{
+			GetEntry(c, moved->Newer)->Older = lruIndex;
+		}
+		else
+		{
+			c->Newest = lruIndex;
+		}
+		if (moved->Older >= 0)
+		{
+			GetEntry(c, moved->Older)->Newer = lruIndex;
+		}
+		else
+		{
+			c->Oldest = lruIndex;
+		}
+		memcpy(e, moved, sizeof *e);
+	}
+	CArrayDelete(&c->Entries, last);
+}
+
+const NamedSprites *ActorPicCacheGetSprites(
+	const ActorPicCache *c, const CharSprites *cs, const int variant)
+{
+	CA_FOREACH(const ActorSpritesCacheEntry, e, c->Sprites)
+		if (e->CharSprites == cs && e->Variant == variant)
+		{
+			return e->Sprites;
+		}
+	CA_FOREACH_END()
+	return NULL;
+}
+void ActorPicCacheAddSprites(
+	ActorPicCache *c, const CharSprites *cs, const int variant,
+	const NamedSprites *sprites)
+{
+	if (c->Sprites.elemSize == 0)
+	{
+		return;
+	}
+	ActorSpritesCacheEntry e;
+	e.CharSprites = cs;
+	e.Variant = variant;
+	e.Sprites = sprites;
+	CArrayPushBack(&c->Sprites, &e);
+}
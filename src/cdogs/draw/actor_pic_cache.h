@@ -0,0 +1,80 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "blit.h"
+#include "c_array.h"
+#include "cpic.h"
+#include "draw/char_sprites.h"
+#include "pic.h"
+
+// Memory cap for the composited actor pics, in bytes
+#define ACTOR_PIC_CACHE_MEMORY (4 * 1024 * 1024)
+
+// Cache of actor pics with the body parts composited into one pic, and
+// coloured with the character's colours, so that each actor can be drawn
+// with a single blit.
+// Least recently used pics are evicted once the memory cap is exceeded.
+// Entries are chained into hash buckets and into a list in the order they
+// were used, so both lookups and evictions take constant time.
+typedef struct
+{
+	CArray Entries;	// of ActorPicCacheEntry
+	CArray Buckets;	// of int, first entry in each hash bucket or -1
+	// Most and least recently used entries, or -1
+	int Newest;
+	int Oldest;
+	CArray Sprites;	// of ActorSpritesCacheEntry
+	size_t Memory;
+	size_t MaxMemory;
+} ActorPicCache;
+extern ActorPicCache gActorPicCache;
+
+void ActorPicCacheInit(ActorPicCache *c, const size_t maxMemory);
+void ActorPicCacheTerminate(ActorPicCache *c);
+// Free all cached pics and sprites; call when the part pics may have been
+// unloaded
+void ActorPicCacheClear(ActorPicCache *c);
+
+// Get the composited pic for the body parts (in draw order, NULL parts are
+// skipped) with their draw offsets, coloured by the character colours.
+// The pic's offset is relative to the actor's draw position.
+// Returns NULL if the cache isn't initialised.
+const Pic *ActorPicCacheGet(
+	ActorPicCache *c, const Pic *const pics[BODY_PART_COUNT],
+	const Vec2i offsets[BODY_PART_COUNT], const CharColors *colors);
+
+// Memoised sprites for a char sprites class, keyed by a caller-defined
+// variant, so that sprite names aren't formatted and hashed every frame.
+// Returns NULL if not cached.
+const NamedSprites *ActorPicCacheGetSprites(
+	const ActorPicCache *c, const CharSprites *cs, const int variant);
+void ActorPicCacheAddSprites(
+	ActorPicCache *c, const CharSprites *cs, const int variant,
+	const NamedSprites *sprites);
@@ -66,6 +66,7 @@
 #include "draw/draw.h"
 #include "blit.h"
 #include "pic_manager.h"
+#include "thread_pool.h"
 
 //#define DEBUG_DRAW_HITBOXES
 
@@ -103,7 +104,7 @@ void DrawWallColumn(int y, Vec2i pos, Tile *tile)
 			Blit(&gGraphicsDevice, &tile->pic->pic, pos);
 			break;
 		case TILE_LOS_FOG:
-			BlitMasked(&gGraphicsDevice, &tile->pic->pic, pos, colorFog, false);
+			Blit(&gGraphicsDevice, NamedPicGetFogged(tile->pic), pos);
 			break;
 		case TILE_LOS_NONE:
 		default:
@@ -141,44 +142,104 @@ void DrawBufferDraw(DrawBuffer *b, Vec2i offset, GrafxDrawExtra *extra)
 	}
 }
 
+// The floor pass only blits tile-sized pics that cover nothing but each
+// other, so it is split into horizontal bands of the clip area, one per
+// thread pool job, each clipped to its own rows of the screen
+#define FLOOR_BAND_MIN_HEIGHT 32
+typedef struct
+{
+	const DrawBuffer *b;
+	Vec2i offset;
+	bool useFog;
+	BlitClipping clip;
+	int bandHeight;
+} DrawFloorData;
+static void DrawFloorBand(void *data, const int index);
+static bool IsFloorDrawn(const Tile *tile)
+{
+	return tile->pic != NULL && tile->pic->pic.Data != NULL &&
+		!(tile->flags & MAPTILE_IS_WALL);
+}
 static void DrawFloor(DrawBuffer *b, Vec2i offset)
 {
-	int x, y;
-	Vec2i pos;
-	const Tile *tile = &b->tiles[0][0];
-	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
-	for (y = 0, pos.y = b->dy + offset.y;
-		 y < Y_TILES;
-		 y++, pos.y += TILE_HEIGHT)
+	DrawFloorData data;
+	data.b = b;
+	data.offset = offset;
+	data.useFog = ConfigGetBool(&gConfig, "Game.Fog");
+	data.clip = b->g->clipping;
+	const int height = data.clip.bottom - data.clip.top + 1;
+	if (height <= 0)
 	{
-		for (x = 0, pos.x = b->dx + offset.x;
-			x < b->Size.x;
-			x++, tile++, pos.x += TILE_WIDTH)
+		return;
+	}
+
+	// Fogged pics are made on first use; do that here rather than from
+	// several jobs at once
+	if (data.useFog)
+	{
+		Tile *tile = &b->tiles[0][0];
+		for (int y = 0; y < Y_TILES; y++)
 		{
-			if (tile->pic != NULL && tile->pic->pic.Data != NULL &&
-				!(tile->flags & MAPTILE_IS_WALL))
+			for (int x = 0; x < b->Size.x; x++, tile++)
 			{
-				switch (GetTileLOS(tile, useFog))
+				if (IsFloorDrawn(tile) &&
+					GetTileLOS(tile, true) == TILE_LOS_FOG)
 				{
-				case TILE_LOS_NORMAL:
-					Blit(&gGraphicsDevice, &tile->pic->pic, pos);
-					break;
-				case TILE_LOS_FOG:
-					BlitMasked(
-						&gGraphicsDevice,
-						&tile->pic->pic,
-						pos,
-						colorFog,
-						false);
-					break;
-				case TILE_LOS_NONE:
-				default:
-					// don't draw
-					break;
+					NamedPicGetFogged(tile->pic);
 				}
 			}
+			tile += X_TILES - b->Size.x;
+		}
+	}
+
+	const int numThreads = (int)gThreadPool.threads.size + 1;
+	const int numBands =
+		CLAMP(height / FLOOR_BAND_MIN_HEIGHT, 1, numThreads);
+	data.bandHeight = (height + numBands - 1) / numBands;
+	ThreadPoolParallelFor(&gThreadPool, DrawFloorBand, &data, numBands);
+}
+static void DrawFloorBand(void *data, const int index)
+{
+	const DrawFloorData *d = data;
+	const DrawBuffer *b = d->b;
+	BlitClipping clip = d->clip;
+	clip.top = d->clip.top + index * d->bandHeight;
+	clip.bottom = MIN(clip.top + d->bandHeight - 1, d->clip.bottom);
+	Vec2i pos;
+	pos.y = b->dy + d->offset.y;
+	for (int y = 0; y < Y_TILES; y++, pos.y += TILE_HEIGHT)
+	{
+		if (pos.y > clip.bottom)
+		{
+			break;
+		}
+		if (pos.y + TILE_HEIGHT <= clip.top)
+		{
+			continue;
+		}
+		const Tile *tile = &b->tiles[0][0] + y * X_TILES;
+		pos.x = b->dx + d->offset.x;
+		for (int x = 0; x < b->Size.x; x++, tile++, pos.x += TILE_WIDTH)
+		{
+			if (!IsFloorDrawn(tile))
+			{
+				continue;
+			}
+			switch (GetTileLOS(tile, d->useFog))
+			{
+			case TILE_LOS_NORMAL:
+				BlitClipped(b->g, &tile->pic->pic, pos, &clip);
+				break;
+			case TILE_LOS_FOG:
+				BlitClipped(
+					b->g, NamedPicGetFogged(tile->pic), pos, &clip);
+				break;
+			case TILE_LOS_NONE:
+			default:
+				// don't draw
+				break;
+			}
 		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 
@@ -196,13 +257,12 @@ static void DrawDebris(DrawBuffer *b, Vec2i offset)
 			{
 				continue;
 			}
-			CA_FOREACH(ThingId, tid, tile->things)
-				const TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				if (TileItemDrawLast(ti))
 				{
 					CArrayPushBack(&b->displaylist, &ti);
 				}
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 		DrawBufferSortDisplayList(b);
 		CA_FOREACH(const TTileItem *, tp, b->displaylist)
@@ -250,12 +310,10 @@ static void DrawWallsAndThings(DrawBuffer *b, Vec2i offset)
 					Blit(&gGraphicsDevice, &tile->picAlt->pic, doorPos);
 					break;
 				case TILE_LOS_FOG:
-					BlitMasked(
+					Blit(
 						&gGraphicsDevice,
-						&tile->picAlt->pic,
-						doorPos,
-						colorFog,
-						false);
+						NamedPicGetFogged(tile->picAlt),
+						doorPos);
 					break;
 				case TILE_LOS_NONE:
 				default:
@@ -269,15 +327,14 @@ static void DrawWallsAndThings(DrawBuffer *b, Vec2i offset)
 			{
 				continue;
 			}
-			CA_FOREACH(ThingId, tid, tile->things)
-				const TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				// Drawn later
 				if (TileItemDrawLast(ti))
 				{
 					continue;
 				}
 				CArrayPushBack(&b->displaylist, &ti);
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 		DrawBufferSortDisplayList(b);
 		CA_FOREACH(const TTileItem *, tp, b->displaylist)
@@ -387,10 +444,16 @@ static void DrawGuideImage(
 	// so that the guide image stretches to the map size
 	double xScale = (double)guideImage->w / (gMap.Size.x * TILE_WIDTH);
 	double yScale = (double)guideImage->h / (gMap.Size.y * TILE_HEIGHT);
-	for (int j = 0; j < b->g->cachedConfig.Res.y; j++)
+	// Only visit the pixels inside the clip area
+	const BlitClipping *clip = &b->g->clipping;
+	for (int j = MAX(clip->top, 0);
+		j <= MIN(clip->bottom, b->g->cachedConfig.Res.y - 1);
+		j++)
 	{
 		int y = (int)round((j + b->yTop) * yScale);
-		for (int i = 0; i < b->g->cachedConfig.Res.x; i++)
+		for (int i = MAX(clip->left, 0);
+			i <= MIN(clip->right, b->g->cachedConfig.Res.x - 1);
+			i++)
 		{
 			int x = (int)round((i + b->xTop) * xScale);
 			if (x >= 0 && x < guideImage->w && y >= 0 && y < guideImage->h)
@@ -418,8 +481,7 @@ static void DrawObjectNames(DrawBuffer *b, const Vec2i offset)
 	{
 		for (int x = 0; x < b->Size.x; x++, tile++)
 		{
-			CA_FOREACH(ThingId, tid, tile->things)
-				const TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				if (ti->flags & TILEITEM_OBJECTIVE)
 				{
 					DrawObjectiveName(ti, b, offset);
@@ -432,7 +494,7 @@ static void DrawObjectNames(DrawBuffer *b, const Vec2i offset)
 						DrawSpawnerName(obj, b, offset);
 					}
 				}
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 		tile += X_TILES - b->Size.x;
 	}
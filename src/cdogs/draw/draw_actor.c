@@ -56,6 +56,7 @@
 #include "actors.h"
 #include "algorithms.h"
 #include "config.h"
+#include "draw/actor_pic_cache.h"
 #include "draw/drawtools.h"
 #include "font.h"
 #include "game_events.h"
@@ -80,7 +81,6 @@ static Vec2i GetActorDrawOffset(
 	return offset;
 }
 
-static Character *ActorGetCharacterMutable(TActor *a);
 ActorPics GetCharacterPicsFromActor(TActor *a)
 {
 	const Weapon *gun = ActorGetGun(a);
@@ -107,7 +107,7 @@ ActorPics GetCharacterPicsFromActor(TActor *a)
 		mask = &colorPurple;
 	}
 	return GetCharacterPics(
-		ActorGetCharacterMutable(a),
+		ActorGetCharacter(a),
 		RadiansToDirection(a->DrawRadians), a->anim.Type,
 		AnimationGetFrame(&a->anim),
 		gun->Gun->Pic, gun->state,
@@ -125,7 +125,7 @@ static const Pic *GetGunPic(
 	const NamedSprites *gunPics, const direction_e dir, const int gunState);
 static const Pic *GetDeathPic(PicManager *pm, const int frame);
 ActorPics GetCharacterPics(
-	Character *c, const direction_e dir,
+	const Character *c, const direction_e dir,
 	const ActorAnimation anim, const int frame,
 	const NamedSprites *gunPics, const gunstate_e gunState,
 	const bool isTransparent, HSV *tint, color_t *mask,
@@ -224,15 +224,6 @@ ActorPics GetCharacterPics(
 
 	return pics;
 }
-static Character *ActorGetCharacterMutable(TActor *a)
-{
-	if (a->PlayerUID >= 0)
-	{
-		return &PlayerDataGetByUID(a->PlayerUID)->Char;
-	}
-	return CArrayGet(&gCampaign.Setting.characters.OtherChars, a->charId);
-}
-
 static void DrawDyingBody(
 	GraphicsDevice *g, const ActorPics *pics, const Vec2i pos);
 void DrawActorPics(const ActorPics *pics, const Vec2i pos)
@@ -251,6 +242,21 @@ void DrawActorPics(const ActorPics *pics, const Vec2i pos)
 		{
 			DrawShadow(&gGraphicsDevice, pos, Vec2iNew(8, 6));
 		}
+		// Plain coloured actors are drawn from the composited pic cache
+		if (!pics->IsTransparent && pics->Mask == NULL)
+		{
+			const Pic *pic = ActorPicCacheGet(
+				&gActorPicCache, pics->OrderedPics, pics->OrderedOffsets,
+				pics->Colors);
+			if (pic != NULL)
+			{
+				if (!PicIsNone(pic))
+				{
+					Blit(&gGraphicsDevice, pic, pos);
+				}
+				return;
+			}
+		}
 		for (int i = 0; i < BODY_PART_COUNT; i++)
 		{
 			const Pic *pic = pics->OrderedPics[i];
@@ -361,14 +367,13 @@ void DrawChatters(DrawBuffer *b, const Vec2i offset)
 	{
 		for (int x = 0; x < b->Size.x; x++, tile++)
 		{
-			CA_FOREACH(ThingId, tid, tile->things)
-				const TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				if (ti->kind != KIND_CHARACTER)
 				{
 					continue;
 				}
 				DrawChatter(ti, b, offset);
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 		tile += X_TILES - b->Size.x;
 	}
@@ -403,6 +408,9 @@ const Pic *GetHeadPic(
 	const int idx = (int)dir + row * 8;
 	return CPicGetPic(&c->HeadPics, idx);
 }
+static const NamedSprites *GetCharSprites(
+	PicManager *pm, const CharSprites *cs, const bool isLegs,
+	const ActorAnimation anim, const bool isArmed);
 static const Pic *GetBodyPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
 	const ActorAnimation anim, const int frame, const bool isArmed)
@@ -411,13 +419,8 @@ static const Pic *GetBodyPic(
 	const int col = frame % stride;
 	const int row = (int)dir;
 	const int idx = col + row * stride;
-	char buf[CDOGS_PATH_MAX];
-	sprintf(
-		buf, "chars/bodies/%s/upper_%s%s",
-		cs->Name,
-		anim == ACTORANIMATION_IDLE ? "idle" : "run",
-		isArmed ? "_handgun" : "");	// TODO: other gun holding poses
-	return CArrayGet(&PicManagerGetSprites(pm, buf)->pics, idx);
+	return CArrayGet(
+		&GetCharSprites(pm, cs, false, anim, isArmed)->pics, idx);
 }
 static const Pic *GetLegsPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
@@ -427,11 +430,39 @@ static const Pic *GetLegsPic(
 	const int col = frame % stride;
 	const int row = (int)dir;
 	const int idx = col + row * stride;
+	return CArrayGet(&GetCharSprites(pm, cs, true, anim, false)->pics, idx);
+}
+// Look up body/legs sprites by name, memoised in the actor pic cache
+static const NamedSprites *GetCharSprites(
+	PicManager *pm, const CharSprites *cs, const bool isLegs,
+	const ActorAnimation anim, const bool isArmed)
+{
+	const bool isIdle = anim == ACTORANIMATION_IDLE;
+	const int variant = (isLegs ? 4 : 0) | (isIdle ? 0 : 2) | (isArmed ? 1 : 0);
+	const NamedSprites *ns =
+		ActorPicCacheGetSprites(&gActorPicCache, cs, variant);
+	if (ns != NULL)
+	{
+		return ns;
+	}
 	char buf[CDOGS_PATH_MAX];
-	sprintf(
-		buf, "chars/bodies/%s/legs_%s",
-		cs->Name, anim == ACTORANIMATION_IDLE ? "idle" : "run");
-	return CArrayGet(&PicManagerGetSprites(pm, buf)->pics, idx);
+	if (isLegs)
+	{
+		sprintf(
+			buf, "chars/bodies/%s/legs_%s",
+			cs->Name, isIdle ? "idle" : "run");
+	}
+	else
+	{
+		sprintf(
+			buf, "chars/bodies/%s/upper_%s%s",
+			cs->Name,
+			isIdle ? "idle" : "run",
+			isArmed ? "_handgun" : "");	// TODO: other gun holding poses
+	}
+	ns = PicManagerGetSprites(pm, buf);
+	ActorPicCacheAddSprites(&gActorPicCache, cs, variant, ns);
+	return ns;
 }
 static const Pic *GetGunPic(
 	const NamedSprites *gunPics, const direction_e dir, const int gunState)
@@ -85,7 +85,7 @@ void DrawChatters(DrawBuffer *b, const Vec2i offset);
 const Pic *GetHeadPic(
 	const CharacterClass *c, const direction_e dir, const gunstate_e gunState);
 ActorPics GetCharacterPics(
-	Character *c, const direction_e dir,
+	const Character *c, const direction_e dir,
 	const ActorAnimation anim, const int frame,
 	const NamedSprites *gunPics, const gunstate_e gunState,
 	const bool isTransparent, HSV *tint, color_t *mask,
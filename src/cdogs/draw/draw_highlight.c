@@ -68,10 +68,9 @@ void DrawObjectiveHighlights(DrawBuffer *b, const Vec2i offset)
 		for (int x = 0; x < b->Size.x; x++, tile++)
 		{
 			// Draw the items that are in LOS
-			CA_FOREACH(ThingId, tid, tile->things)
-				TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				DrawObjectiveHighlight(ti, tile, b, offset);
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 		tile += X_TILES - b->Size.x;
 	}
@@ -0,0 +1,256 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "file_writer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log.h"
+#include "sys_config.h"
+#include "utils.h"
+
+FileWriter gFileWriter;
+
+
+typedef struct
+{
+	char *Filename;
+	// Either a JSON tree to serialise, or the data to write
+	json_t *Root;
+	char *Data;
+	size_t Size;
+} FileWriterJob;
+
+static int WriterRun(void *data);
+void FileWriterInit(FileWriter *fw)
+{
+	memset(fw, 0, sizeof *fw);
+	CArrayInit(&fw->jobs, sizeof(FileWriterJob));
+	fw->mutex = SDL_CreateMutex();
+	fw->workCond = SDL_CreateCond();
+	fw->doneCond = SDL_CreateCond();
+	if (fw->mutex == NULL || fw->workCond == NULL || fw->doneCond == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot create file writer: %s",
+			SDL_GetError());
+		return;
+	}
+	fw->thread = SDL_CreateThread(WriterRun, "file writer", fw);
+	if (fw->thread == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot create file writer thread: %s",
+			SDL_GetError());
+	}
+}
+void FileWriterTerminate(FileWriter *fw)
+{
+	if (fw->thread != NULL)
+	{
+		// The thread writes everything waiting before it quits
+		SDL_LockMutex(fw->mutex);
+		fw->quit = true;
+		SDL_CondSignal(fw->workCond);
+		SDL_UnlockMutex(fw->mutex);
+		SDL_WaitThread(fw->thread, NULL);
+	}
+	CArrayTerminate(&fw->jobs);
+	SDL_DestroyCond(fw->doneCond);
+	SDL_DestroyCond(fw->workCond);
+	SDL_DestroyMutex(fw->mutex);
+	memset(fw, 0, sizeof *fw);
+}
+
+static bool JobRun(FileWriterJob *job);
+static void JobTerminate(FileWriterJob *job);
+static int WriterRun(void *data)
+{
+	FileWriter *fw = data;
+	SDL_LockMutex(fw->mutex);
+	for (;;)
+	{
+		while (!fw->quit && fw->jobs.size == 0)
+		{
+			SDL_CondWait(fw->workCond, fw->mutex);
+		}
+		if (fw->jobs.size == 0)
+		{
+			break;
+		}
+		FileWriterJob job = *(FileWriterJob *)CArrayGet(&fw->jobs, 0);
+		CArrayDelete(&fw->jobs, 0);
+		fw->busy = true;
+		SDL_UnlockMutex(fw->mutex);
+
+		const bool ok = JobRun(&job);
+		JobTerminate(&job);
+
+		SDL_LockMutex(fw->mutex);
+		fw->busy = false;
+		if (!ok)
+		{
+			fw->failed = true;
+		}
+		SDL_CondBroadcast(fw->doneCond);
+	}
+	SDL_UnlockMutex(fw->mutex);
+	return 0;
+}
+
+static void AddJob(FileWriter *fw, FileWriterJob *job);
+void FileWriterSaveJSON(FileWriter *fw, const char *filename, json_t *root)
+{
+	FileWriterJob job;
+	memset(&job, 0, sizeof job);
+	CSTRDUP(job.Filename, filename);
+	job.Root = root;
+	AddJob(fw, &job);
+}
+void FileWriterSave(
+	FileWriter *fw, const char *filename, char *data, const size_t size)
+{
+	FileWriterJob job;
+	memset(&job, 0, sizeof job);
+	CSTRDUP(job.Filename, filename);
+	job.Data = data;
+	job.Size = size;
+	AddJob(fw, &job);
+}
+static void AddJob(FileWriter *fw, FileWriterJob *job)
+{
+	if (fw->thread == NULL)
+	{
+		if (!JobRun(job))
+		{
+			fw->failed = true;
+		}
+		JobTerminate(job);
+		return;
+	}
+	SDL_LockMutex(fw->mutex);
+	bool replaced = false;
+	CA_FOREACH(FileWriterJob, j, fw->jobs)
+		if (strcmp(j->Filename, job->Filename) == 0)
+		{
+			// Not written yet; only the latest save matters
+			JobTerminate(j);
+			*j = *job;
+			replaced = true;
+			break;
+		}
+	CA_FOREACH_END()
+	if (!replaced)
+	{
+		CArrayPushBack(&fw->jobs, job);
+	}
+	SDL_CondSignal(fw->workCond);
+	SDL_UnlockMutex(fw->mutex);
+}
+
+bool FileWriterFlush(FileWriter *fw)
+{
+	bool ok;
+	if (fw->thread == NULL)
+	{
+		ok = !fw->failed;
+		fw->failed = false;
+		return ok;
+	}
+	SDL_LockMutex(fw->mutex);
+	while (fw->jobs.size > 0 || fw->busy)
+	{
+		SDL_CondWait(fw->doneCond, fw->mutex);
+	}
+	ok = !fw->failed;
+	fw->failed = false;
+	SDL_UnlockMutex(fw->mutex);
+	return ok;
+}
+
+static bool WriteFileAtomic(
+	const char *filename, const char *data, const size_t size);
+static bool JobRun(FileWriterJob *job)
+{
+	if (job->Root != NULL)
+	{
+		char *text;
+		json_tree_to_string(job->Root, &text);
+		char *ftext = json_format_string(text);
+		const bool ok = WriteFileAtomic(job->Filename, ftext, strlen(ftext));
+		CFREE(text);
+		CFREE(ftext);
+		return ok;
+	}
+	return WriteFileAtomic(job->Filename, job->Data, job->Size);
+}
+// Write to a temporary file first and rename it over the file, so that the
+// file is never left half-written
+static bool WriteFileAtomic(
+	const char *filename, const char *data, const size_t size)
+{
+	char tmpName[CDOGS_PATH_MAX];
+	snprintf(tmpName, sizeof tmpName, "%s.tmp", filename);
+	FILE *f = fopen(tmpName, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to open file(%s) for saving: %s",
+			tmpName, strerror(errno));
+		return false;
+	}
+	const size_t rc = fwrite(data, 1, size, f);
+	if (fclose(f) != 0 || rc != size)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Wrote (%d) of (%d) bytes to %s: %s",
+			(int)rc, (int)size, tmpName, strerror(errno));
+		remove(tmpName);
+		return false;
+	}
+	if (rename(tmpName, filename) != 0)
+	{
+		// Some platforms will not rename over an existing file
+		remove(filename);
+		if (rename(tmpName, filename) != 0)
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to rename %s to %s: %s",
+				tmpName, filename, strerror(errno));
+			remove(tmpName);
+			return false;
+		}
+	}
+	return true;
+}
+static void JobTerminate(FileWriterJob *job)
+{
+	CFREE(job->Filename);
+	if (job->Root != NULL)
+	{
+		json_free_value(&job->Root);
+	}
+	CFREE(job->Data);
+}
@@ -0,0 +1,75 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+#include <json/json.h>
+
+#include "c_array.h"
+
+// Writes files on a background thread so that saving never blocks the game
+// Callers snapshot what they save (a JSON tree or a byte buffer) on their
+// own thread; the writer then serialises it and replaces the file
+// atomically, by writing a temporary file and renaming it over the old one.
+// A save to a file that is still waiting to be written replaces the
+// waiting one, so rapid repeated saves only write the latest.
+typedef struct
+{
+	SDL_Thread *thread;
+	SDL_mutex *mutex;
+	SDL_cond *workCond;
+	SDL_cond *doneCond;
+	CArray jobs;	// of FileWriterJob, waiting to be written
+	bool busy;
+	bool quit;
+	bool failed;	// a save has failed since the last flush
+} FileWriter;
+
+extern FileWriter gFileWriter;
+
+// Start the writer thread
+// Until this is called, or if the thread cannot be started, saves are
+// written immediately on the calling thread.
+void FileWriterInit(FileWriter *fw);
+// Finish writing all waiting saves, then stop the thread
+void FileWriterTerminate(FileWriter *fw);
+
+// Save a JSON tree; the writer takes ownership of the tree
+void FileWriterSaveJSON(FileWriter *fw, const char *filename, json_t *root);
+// Save a buffer allocated with CMALLOC; the writer takes ownership of it
+void FileWriterSave(
+	FileWriter *fw, const char *filename, char *data, const size_t size);
+// Wait until all waiting saves have been written
+// Returns whether every save since the last flush was written successfully
+bool FileWriterFlush(FileWriter *fw);
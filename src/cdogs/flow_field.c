@@ -0,0 +1,246 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "flow_field.h"
+
+#include <string.h>
+
+#include "ai_utils.h"
+#include "log.h"
+
+// Neighbours, axis-aligned first so that they are preferred over diagonals
+static const Vec2i sDirs[] =
+{
+	{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+	{ 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+};
+#define NUM_DIRS (sizeof sDirs / sizeof sDirs[0])
+
+
+void FlowFieldsInit(FlowFields *ff, Map *m)
+{
+	memset(ff, 0, sizeof *ff);
+	ff->map = m;
+	CArrayInit(&ff->Fields, sizeof(FlowField));
+	ff->IsWalkableDirty = true;
+}
+void FlowFieldsTerminate(FlowFields *ff)
+{
+	CA_FOREACH(FlowField, f, ff->Fields)
+		CFREE(f->Dist);
+	CA_FOREACH_END()
+	CArrayTerminate(&ff->Fields);
+	CFREE(ff->Walkable);
+	CFREE(ff->Queue);
+}
+
+void FlowFieldsInvalidate(FlowFields *ff)
+{
+	ff->IsWalkableDirty = true;
+	CA_FOREACH(FlowField, f, ff->Fields)
+		f->IsDirty = true;
+	CA_FOREACH_END()
+}
+
+static int TileIndex(const Map *m, const Vec2i tile)
+{
+	return tile.y * m->Size.x + tile.x;
+}
+static bool IsTileIn(const Map *m, const Vec2i tile)
+{
+	return tile.x >= 0 && tile.x < m->Size.x &&
+		tile.y >= 0 && tile.y < m->Size.y;
+}
+static bool IsWalkable(const FlowFields *ff, const Vec2i tile)
+{
+	return IsTileIn(ff->map, tile) && ff->Walkable[TileIndex(ff->map, tile)];
+}
+// Can we step in this direction; diagonal steps need the axis-aligned
+// neighbours to be clear too, so we don't get caught on corners
+static bool CanStep(const FlowFields *ff, const Vec2i tile, const Vec2i d)
+{
+	if (!IsWalkable(ff, Vec2iAdd(tile, d)))
+	{
+		return false;
+	}
+	if (d.x != 0 && d.y != 0)
+	{
+		return IsWalkable(ff, Vec2iNew(tile.x + d.x, tile.y)) &&
+			IsWalkable(ff, Vec2iNew(tile.x, tile.y + d.y));
+	}
+	return true;
+}
+
+static void UpdateWalkable(FlowFields *ff)
+{
+	const int numTiles = ff->map->Size.x * ff->map->Size.y;
+	if (ff->Walkable == NULL)
+	{
+		CMALLOC(ff->Walkable, numTiles * sizeof *ff->Walkable);
+		CMALLOC(ff->Queue, numTiles * sizeof *ff->Queue);
+	}
+	Vec2i v;
+	for (v.y = 0; v.y < ff->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < ff->map->Size.x; v.x++)
+		{
+			ff->Walkable[TileIndex(ff->map, v)] =
+				IsTileWalkable(ff->map, v);
+		}
+	}
+	ff->IsWalkableDirty = false;
+}
+
+// Breadth-first search outwards from the target
+static void FlowFieldBuild(FlowFields *ff, FlowField *f)
+{
+	const Map *m = ff->map;
+	const int numTiles = m->Size.x * m->Size.y;
+	if (f->Dist == NULL)
+	{
+		CMALLOC(f->Dist, numTiles * sizeof *f->Dist);
+	}
+	for (int i = 0; i < numTiles; i++)
+	{
+		f->Dist[i] = FLOW_FIELD_UNREACHABLE;
+	}
+	f->IsDirty = false;
+	if (!IsTileIn(m, f->Target))
+	{
+		return;
+	}
+	int head = 0;
+	int tail = 0;
+	// Note: the target itself may be unwalkable, e.g. if an actor is
+	// standing next to an explosive barrel; always start from it
+	const int targetIndex = TileIndex(m, f->Target);
+	f->Dist[targetIndex] = 0;
+	ff->Queue[tail++] = targetIndex;
+	while (head < tail)
+	{
+		const int index = ff->Queue[head++];
+		const Vec2i tile = Vec2iNew(index % m->Size.x, index / m->Size.x);
+		for (int i = 0; i < (int)NUM_DIRS; i++)
+		{
+			if (!CanStep(ff, tile, sDirs[i]))
+			{
+				continue;
+			}
+			const int nIndex = TileIndex(m, Vec2iAdd(tile, sDirs[i]));
+			if (f->Dist[nIndex] != FLOW_FIELD_UNREACHABLE)
+			{
+				continue;
+			}
+			f->Dist[nIndex] = f->Dist[index] + 1;
+			ff->Queue[tail++] = nIndex;
+		}
+	}
+	LOG(LM_PATH, LL_TRACE, "built flow field %d to (%d, %d), %d tiles",
+		f->Id, f->Target.x, f->Target.y, tail);
+}
+
+static FlowField *FindOrAddField(FlowFields *ff, const int id)
+{
+	FlowField *lru = NULL;
+	CA_FOREACH(FlowField, f, ff->Fields)
+		if (f->Id == id)
+		{
+			return f;
+		}
+		if (lru == NULL || f->LastUsed < lru->LastUsed)
+		{
+			lru = f;
+		}
+	CA_FOREACH_END()
+	if ((int)ff->Fields.size < FLOW_FIELDS_MAX)
+	{
+		FlowField f;
+		memset(&f, 0, sizeof f);
+		CArrayPushBack(&ff->Fields, &f);
+		lru = CArrayGet(&ff->Fields, (int)ff->Fields.size - 1);
+	}
+	// Reuse the least recently used field, keeping its buffer
+	lru->Id = id;
+	lru->IsDirty = true;
+	lru->LastBuilt = -1;
+	return lru;
+}
+
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int id, const Vec2i target, const int ticks)
+{
+	if (ff->IsWalkableDirty)
+	{
+		UpdateWalkable(ff);
+	}
+	FlowField *f = FindOrAddField(ff, id);
+	f->LastUsed = ticks;
+	// If the target has moved, rebuild, but only once per tick
+	if (!Vec2iEqual(f->Target, target) && f->LastBuilt != ticks)
+	{
+		f->Target = target;
+		f->IsDirty = true;
+	}
+	if (f->IsDirty)
+	{
+		FlowFieldBuild(ff, f);
+		f->LastBuilt = ticks;
+	}
+	return f;
+}
+
+bool FlowFieldGetNextTile(
+	const FlowFields *ff, const FlowField *f, const Vec2i tile, Vec2i *next)
+{
+	if (!IsTileIn(ff->map, tile))
+	{
+		return false;
+	}
+	const int dist = f->Dist[TileIndex(ff->map, tile)];
+	if (dist <= 0)
+	{
+		return false;
+	}
+	for (int i = 0; i < (int)NUM_DIRS; i++)
+	{
+		const Vec2i n = Vec2iAdd(tile, sDirs[i]);
+		if (!IsTileIn(ff->map, n) ||
+			f->Dist[TileIndex(ff->map, n)] != dist - 1)
+		{
+			continue;
+		}
+		// The target itself may be unwalkable
+		if (!Vec2iEqual(n, f->Target) && !CanStep(ff, tile, sDirs[i]))
+		{
+			continue;
+		}
+		*next = n;
+		return true;
+	}
+	return false;
+}
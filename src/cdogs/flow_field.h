@@ -0,0 +1,81 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Flow fields (Dijkstra maps)
+// A flow field stores, for every tile, the walking distance to a target
+// tile. Any number of actors going to the same target can then find their
+// next step by looking at their neighbouring tiles, instead of each
+// running their own path search.
+// Fields are keyed by an id (e.g. the target actor's UID) so that they can
+// be reused as the target moves; they are only rebuilt when the target
+// changes tile or the map changes, and at most once per tick.
+
+#define FLOW_FIELDS_MAX 8
+#define FLOW_FIELD_UNREACHABLE -1
+
+typedef struct
+{
+	int Id;
+	Vec2i Target;
+	int *Dist;	// per tile
+	bool IsDirty;
+	int LastBuilt;
+	int LastUsed;
+} FlowField;
+typedef struct
+{
+	Map *map;
+	CArray Fields;	// of FlowField
+	// Shared scratch; walkability of each tile and the BFS queue
+	bool *Walkable;
+	bool IsWalkableDirty;
+	int *Queue;
+} FlowFields;
+
+void FlowFieldsInit(FlowFields *ff, Map *m);
+void FlowFieldsTerminate(FlowFields *ff);
+
+// Mark all fields as needing a rebuild, e.g. when tile walkability changes
+void FlowFieldsInvalidate(FlowFields *ff);
+
+// Get the field for a target, updating it if the target has moved
+// ticks: current game time, used to reuse least recently used fields
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int id, const Vec2i target, const int ticks);
+// Get the next tile to step to towards the field's target
+// Returns false if the tile is the target or cannot reach it
+bool FlowFieldGetNextTile(
+	const FlowFields *ff, const FlowField *f, const Vec2i tile, Vec2i *next);
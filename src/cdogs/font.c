@@ -41,6 +41,34 @@
 
 Font gFont;
 
+// Cache of rendered strings, since most text is redrawn unchanged every
+// frame. Each entry holds the whole string already masked, to be drawn
+// with a single blit.
+#define FONT_CACHE_SIZE 64
+#define FONT_CACHE_MAX_LEN 256
+typedef struct
+{
+	char *Str;
+	Uint32 Hash;
+	color_t Mask;
+	Pic Pic;
+	// Cursor position after drawing, relative to the start
+	Vec2i End;
+	int LastUsed;
+} FontCacheEntry;
+static FontCacheEntry sFontCache[FONT_CACHE_SIZE];
+static int sFontCacheCount = 0;
+static int sFontCacheTicks = 0;
+static void FontCacheClear(void)
+{
+	for (int i = 0; i < sFontCacheCount; i++)
+	{
+		CFREE(sFontCache[i].Str);
+		PicFree(&sFontCache[i].Pic);
+	}
+	sFontCacheCount = 0;
+}
+
 
 FontOpts FontOptsNew(void)
 {
@@ -52,6 +80,7 @@ FontOpts FontOptsNew(void)
 
 void FontLoad(Font *f, const char *imgPath, const bool isProportional)
 {
+	FontCacheClear();
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, imgPath);
 	SDL_RWops *rwops = SDL_RWFromFile(buf, "rb");
@@ -121,6 +150,7 @@ bail:
 }
 void FontTerminate(Font *f)
 {
+	FontCacheClear();
 	CA_FOREACH(Pic, p, f->Chars)
 		PicFree(p);
 	CA_FOREACH_END()
@@ -170,22 +200,29 @@ int FontStrH(const char *s)
 }
 Vec2i FontStrSize(const char *s)
 {
+	// Measure all lines in one pass
+	const char *start = s;
 	Vec2i size = Vec2iZero();
-	while (*s)
+	int w = 0;
+	for (; *s; s++)
 	{
-		char *lineEnd = strchr(s, '\n');
-		size.y += FontH();
-		if (lineEnd)
+		if (*s == '\n')
 		{
-			size.x = MAX(size.x, FontSubstrW(s, lineEnd - s));
-			s = lineEnd + 1;
+			size.x = MAX(size.x, w);
+			size.y += FontH();
+			w = 0;
 		}
 		else
 		{
-			size.x = MAX(size.x, FontStrW(s));
-			s += strlen(s);
+			w += FontW(*s);
 		}
 	}
+	// Last line, unless the string ends with a newline
+	if (s > start && s[-1] != '\n')
+	{
+		size.y += FontH();
+	}
+	size.x = MAX(size.x, w);
 	return size;
 }
 int FontStrNumLines(const char *s)
@@ -212,8 +249,7 @@ Vec2i FontChMask(const char c, const Vec2i pos, const color_t mask)
 {
 	return FontChColor(c, pos, mask, false);
 }
-static Vec2i FontChColor(
-	const char c, const Vec2i pos, const color_t color, const bool blend)
+static const Pic *GetCharPic(const char c)
 {
 	int idx = (int)c - FIRST_CHAR;
 	if (idx < 0)
@@ -225,7 +261,12 @@ static Vec2i FontChColor(
 		fprintf(stderr, "invalid char %d\n", idx);
 		idx = FIRST_CHAR;
 	}
-	const Pic *pic = CArrayGet(&gFont.Chars, idx);
+	return CArrayGet(&gFont.Chars, idx);
+}
+static Vec2i FontChColor(
+	const char c, const Vec2i pos, const color_t color, const bool blend)
+{
+	const Pic *pic = GetCharPic(c);
 	if (blend)
 	{
 		BlitBlend(&gGraphicsDevice, pic, pos, color);
@@ -243,9 +284,148 @@ Vec2i FontStr(const char *s, Vec2i pos)
 }
 static Vec2i FontStrColor(
 	const char *s, Vec2i pos, const color_t c, const bool blend);
+static const FontCacheEntry *FontCacheGet(const char *s, const color_t mask);
 Vec2i FontStrMask(const char *s, Vec2i pos, const color_t mask)
 {
-	return FontStrColor(s, pos, mask, false);
+	const FontCacheEntry *e = FontCacheGet(s, mask);
+	if (e == NULL)
+	{
+		return FontStrColor(s, pos, mask, false);
+	}
+	if (!PicIsNone(&e->Pic))
+	{
+		Blit(&gGraphicsDevice, &e->Pic, pos);
+	}
+	return Vec2iAdd(pos, e->End);
+}
+static Uint32 StrHash(const char *s)
+{
+	// djb2
+	Uint32 hash = 5381;
+	for (; *s; s++)
+	{
+		hash = hash * 33 + (Uint8)*s;
+	}
+	return hash;
+}
+static void FontCacheRender(FontCacheEntry *e);
+static const FontCacheEntry *FontCacheGet(const char *s, const color_t mask)
+{
+	if (gFont.Chars.size == 0 || strlen(s) >= FONT_CACHE_MAX_LEN)
+	{
+		return NULL;
+	}
+	sFontCacheTicks++;
+	const Uint32 hash = StrHash(s);
+	FontCacheEntry *e = NULL;
+	for (int i = 0; i < sFontCacheCount; i++)
+	{
+		FontCacheEntry *c = &sFontCache[i];
+		if (c->Hash == hash && ColorEquals(c->Mask, mask) &&
+			c->Mask.a == mask.a && strcmp(c->Str, s) == 0)
+		{
+			c->LastUsed = sFontCacheTicks;
+			return c;
+		}
+		if (e == NULL || c->LastUsed < e->LastUsed)
+		{
+			e = c;
+		}
+	}
+	// Not found; use a new entry or replace the least recently used
+	if (sFontCacheCount < FONT_CACHE_SIZE)
+	{
+		e = &sFontCache[sFontCacheCount];
+		sFontCacheCount++;
+	}
+	else
+	{
+		CFREE(e->Str);
+		PicFree(&e->Pic);
+	}
+	CSTRDUP(e->Str, s);
+	e->Hash = hash;
+	e->Mask = mask;
+	e->LastUsed = sFontCacheTicks;
+	FontCacheRender(e);
+	return e;
+}
+// Draw the string masked into the entry's pic, with the same results as
+// blitting each character with BlitMasked
+static void FontCacheRender(FontCacheEntry *e)
+{
+	// Find the bounds of all the characters
+	Vec2i min = Vec2iZero();
+	Vec2i max = Vec2iZero();
+	bool hasPixels = false;
+	Vec2i pos = Vec2iZero();
+	for (const char *s = e->Str; *s; s++)
+	{
+		if (*s == '\n')
+		{
+			pos.x = 0;
+			pos.y += FontH();
+			continue;
+		}
+		const Pic *pic = GetCharPic(*s);
+		if (!PicIsNone(pic))
+		{
+			const Vec2i picMin = Vec2iAdd(pos, pic->offset);
+			const Vec2i picMax = Vec2iAdd(picMin, pic->size);
+			min = hasPixels ? Vec2iMin(min, picMin) : picMin;
+			max = hasPixels ? Vec2iMax(max, picMax) : picMax;
+			hasPixels = true;
+		}
+		pos.x += pic->size.x + gFont.Gap.x;
+	}
+	e->End = pos;
+	memset(&e->Pic, 0, sizeof e->Pic);
+	if (!hasPixels)
+	{
+		return;
+	}
+
+	e->Pic.size = Vec2iMinus(max, min);
+	e->Pic.offset = min;
+	const int size = e->Pic.size.x * e->Pic.size.y;
+	CCALLOC(e->Pic.Data, size * sizeof *e->Pic.Data);
+	const Uint32 maskPixel = COLOR2PIXEL(e->Mask);
+	const SDL_PixelFormat *f = gGraphicsDevice.Format;
+	pos = Vec2iZero();
+	for (const char *s = e->Str; *s; s++)
+	{
+		if (*s == '\n')
+		{
+			pos.x = 0;
+			pos.y += FontH();
+			continue;
+		}
+		const Pic *pic = GetCharPic(*s);
+		if (!PicIsNone(pic))
+		{
+			const Vec2i picPos =
+				Vec2iMinus(Vec2iAdd(pos, pic->offset), min);
+			const Uint32 *src = pic->Data;
+			for (int y = 0; y < pic->size.y; y++)
+			{
+				Uint32 *dst =
+					e->Pic.Data + (picPos.y + y) * e->Pic.size.x + picPos.x;
+				for (int x = 0; x < pic->size.x; x++, src++, dst++)
+				{
+					// Same transparency test as BlitMasked
+					if (((*src & f->Amask) >> f->Ashift) < 3)
+					{
+						continue;
+					}
+					// Written the same way as BlitMasked; drawn pixels are
+					// opaque so the cached pic's Blit copies them unchanged
+					*dst = PixelMult(*src, maskPixel);
+					*dst |= f->Amask;
+				}
+			}
+		}
+		pos.x += pic->size.x + gFont.Gap.x;
+	}
 }
 static Vec2i FontStrColor(
 	const char *s, Vec2i pos, const color_t c, const bool blend)
@@ -28,6 +28,7 @@
 */
 #include "game_events.h"
 
+#include <stddef.h>
 #include <string.h>
 
 #include "actors.h"
@@ -36,15 +37,21 @@
 #include "utils.h"
 
 
-CArray gGameEvents;
+GameEventStore gGameEvents;
 
-void GameEventsInit(CArray *store)
+void GameEventsInit(GameEventStore *store)
 {
-	CArrayInit(store, sizeof(GameEvent));
+	memset(store, 0, sizeof *store);
+	CArrayInit(&store->Blocks, sizeof(GameEventBlock));
+	CArrayInit(&store->Delayed, sizeof(GameEvent));
 }
-void GameEventsTerminate(CArray *store)
+void GameEventsTerminate(GameEventStore *store)
 {
-	CArrayTerminate(store);
+	CA_FOREACH(GameEventBlock, b, store->Blocks)
+		CFREE(b->Data);
+	CA_FOREACH_END()
+	CArrayTerminate(&store->Blocks);
+	CArrayTerminate(&store->Delayed);
 }
 
 
@@ -118,44 +125,120 @@ GameEventEntry GameEventGetEntry(const GameEventType e)
 	return sGameEventEntries[(int)e];
 }
 
-void GameEventsEnqueue(CArray *store, GameEvent e)
+// Size of the part of the event that is used by its type
+#define GAME_EVENT_ALIGN 8
+#define PAYLOAD_SIZE(_member) (int)sizeof(((const GameEvent *)NULL)->u._member)
+static int GameEventSize(const GameEventType type)
 {
-	if (store->elemSize == 0)
+	int payload = 0;
+	switch (type)
+	{
+	case GAME_EVENT_PLAYER_DATA: payload = PAYLOAD_SIZE(PlayerData); break;
+	case GAME_EVENT_PLAYER_REMOVE: payload = PAYLOAD_SIZE(PlayerRemove); break;
+	case GAME_EVENT_TILE_SET: payload = PAYLOAD_SIZE(TileSet); break;
+	case GAME_EVENT_MAP_OBJECT_ADD: payload = PAYLOAD_SIZE(MapObjectAdd); break;
+	case GAME_EVENT_MAP_OBJECT_DAMAGE:
+		payload = PAYLOAD_SIZE(MapObjectDamage);
+		break;
+	case GAME_EVENT_MAP_OBJECT_REMOVE:
+		payload = PAYLOAD_SIZE(MapObjectRemove);
+		break;
+	case GAME_EVENT_CONFIG: payload = PAYLOAD_SIZE(Config); break;
+	case GAME_EVENT_SCORE: payload = PAYLOAD_SIZE(Score); break;
+	case GAME_EVENT_SOUND_AT: payload = PAYLOAD_SIZE(SoundAt); break;
+	case GAME_EVENT_SCREEN_SHAKE: payload = PAYLOAD_SIZE(ShakeAmount); break;
+	case GAME_EVENT_SET_MESSAGE: payload = PAYLOAD_SIZE(SetMessage); break;
+	case GAME_EVENT_GAME_BEGIN: payload = PAYLOAD_SIZE(GameBegin); break;
+	case GAME_EVENT_ACTOR_ADD: payload = PAYLOAD_SIZE(ActorAdd); break;
+	case GAME_EVENT_ACTOR_MOVE: payload = PAYLOAD_SIZE(ActorMove); break;
+	case GAME_EVENT_ACTOR_STATE: payload = PAYLOAD_SIZE(ActorState); break;
+	case GAME_EVENT_ACTOR_DIR: payload = PAYLOAD_SIZE(ActorDir); break;
+	case GAME_EVENT_ACTOR_SLIDE: payload = PAYLOAD_SIZE(ActorSlide); break;
+	case GAME_EVENT_ACTOR_IMPULSE: payload = PAYLOAD_SIZE(ActorImpulse); break;
+	case GAME_EVENT_ACTOR_SWITCH_GUN:
+		payload = PAYLOAD_SIZE(ActorSwitchGun);
+		break;
+	case GAME_EVENT_ACTOR_PICKUP_ALL:
+		payload = PAYLOAD_SIZE(ActorPickupAll);
+		break;
+	case GAME_EVENT_ACTOR_REPLACE_GUN:
+		payload = PAYLOAD_SIZE(ActorReplaceGun);
+		break;
+	case GAME_EVENT_ACTOR_HEAL: payload = PAYLOAD_SIZE(Heal); break;
+	case GAME_EVENT_ACTOR_HIT: payload = PAYLOAD_SIZE(ActorHit); break;
+	case GAME_EVENT_ACTOR_ADD_AMMO: payload = PAYLOAD_SIZE(AddAmmo); break;
+	case GAME_EVENT_ACTOR_USE_AMMO: payload = PAYLOAD_SIZE(UseAmmo); break;
+	case GAME_EVENT_ACTOR_DIE: payload = PAYLOAD_SIZE(ActorDie); break;
+	case GAME_EVENT_ACTOR_MELEE: payload = PAYLOAD_SIZE(Melee); break;
+	case GAME_EVENT_ADD_PICKUP: payload = PAYLOAD_SIZE(AddPickup); break;
+	case GAME_EVENT_REMOVE_PICKUP: payload = PAYLOAD_SIZE(RemovePickup); break;
+	case GAME_EVENT_BULLET_BOUNCE: payload = PAYLOAD_SIZE(BulletBounce); break;
+	case GAME_EVENT_REMOVE_BULLET: payload = PAYLOAD_SIZE(RemoveBullet); break;
+	case GAME_EVENT_PARTICLE_REMOVE:
+		payload = PAYLOAD_SIZE(ParticleRemoveId);
+		break;
+	case GAME_EVENT_GUN_FIRE: payload = PAYLOAD_SIZE(GunFire); break;
+	case GAME_EVENT_GUN_RELOAD: payload = PAYLOAD_SIZE(GunReload); break;
+	case GAME_EVENT_GUN_STATE: payload = PAYLOAD_SIZE(GunState); break;
+	case GAME_EVENT_ADD_BULLET: payload = PAYLOAD_SIZE(AddBullet); break;
+	case GAME_EVENT_ADD_PARTICLE: payload = PAYLOAD_SIZE(AddParticle); break;
+	case GAME_EVENT_TRIGGER: payload = PAYLOAD_SIZE(TriggerEvent); break;
+	case GAME_EVENT_EXPLORE_TILES: payload = PAYLOAD_SIZE(ExploreTiles); break;
+	case GAME_EVENT_RESCUE_CHARACTER: payload = PAYLOAD_SIZE(Rescue); break;
+	case GAME_EVENT_OBJECTIVE_UPDATE:
+		payload = PAYLOAD_SIZE(ObjectiveUpdate);
+		break;
+	case GAME_EVENT_ADD_KEYS: payload = PAYLOAD_SIZE(AddKeys); break;
+	case GAME_EVENT_MISSION_COMPLETE:
+		payload = PAYLOAD_SIZE(MissionComplete);
+		break;
+	case GAME_EVENT_MISSION_END: payload = PAYLOAD_SIZE(MissionEnd); break;
+	default:
+		// No payload
+		break;
+	}
+	const int size = (int)offsetof(GameEvent, u) + payload;
+	return (size + GAME_EVENT_ALIGN - 1) / GAME_EVENT_ALIGN * GAME_EVENT_ALIGN;
+}
+static void GameEventsPush(GameEventStore *store, const GameEvent *e);
+void GameEventsEnqueue(GameEventStore *store, const GameEvent *e)
+{
+	if (store->Blocks.elemSize == 0)
 	{
 		return;
 	}
 	// If we're the server, broadcast any events that clients need
 	// If we're the client, pass along to server, but only if it's for a local player
 	// Otherwise we'd ping-pong the same updates from the server
-	const GameEventEntry gee = sGameEventEntries[e.Type];
+	const GameEventEntry gee = sGameEventEntries[e->Type];
 	if (gee.Broadcast)
 	{
-		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, gee.Type, &e.u);
+		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, gee.Type, &e->u);
 	}
 	if (gee.Submit)
 	{
 		int actorUID = -1;
 		bool actorIsLocal = false;
-		switch (e.Type)
+		switch (e->Type)
 		{
-		case GAME_EVENT_ACTOR_MOVE: actorUID = e.u.ActorMove.UID; break;
-		case GAME_EVENT_ACTOR_STATE: actorUID = e.u.ActorState.UID; break;
-		case GAME_EVENT_ACTOR_DIR: actorUID = e.u.ActorDir.UID; break;
-		case GAME_EVENT_ACTOR_SLIDE: actorUID = e.u.ActorSlide.UID; break;
-		case GAME_EVENT_ACTOR_SWITCH_GUN: actorUID = e.u.ActorSwitchGun.UID; break;
-		case GAME_EVENT_ACTOR_PICKUP_ALL: actorUID = e.u.ActorPickupAll.UID; break;
-		case GAME_EVENT_ACTOR_USE_AMMO: actorUID = e.u.UseAmmo.UID; break;
-		case GAME_EVENT_ACTOR_MELEE: actorUID = e.u.Melee.UID; break;
+		case GAME_EVENT_ACTOR_MOVE: actorUID = e->u.ActorMove.UID; break;
+		case GAME_EVENT_ACTOR_STATE: actorUID = e->u.ActorState.UID; break;
+		case GAME_EVENT_ACTOR_DIR: actorUID = e->u.ActorDir.UID; break;
+		case GAME_EVENT_ACTOR_SLIDE: actorUID = e->u.ActorSlide.UID; break;
+		case GAME_EVENT_ACTOR_SWITCH_GUN: actorUID = e->u.ActorSwitchGun.UID; break;
+		case GAME_EVENT_ACTOR_PICKUP_ALL: actorUID = e->u.ActorPickupAll.UID; break;
+		case GAME_EVENT_ACTOR_USE_AMMO: actorUID = e->u.UseAmmo.UID; break;
+		case GAME_EVENT_ACTOR_MELEE: actorUID = e->u.Melee.UID; break;
 		case GAME_EVENT_GUN_FIRE:
-			if (e.u.GunFire.IsGun)
+			if (e->u.GunFire.IsGun)
 			{
-				actorIsLocal = PlayerIsLocal(e.u.GunFire.PlayerUID);
+				actorIsLocal = PlayerIsLocal(e->u.GunFire.PlayerUID);
 			}
 			break;
 		case GAME_EVENT_GUN_RELOAD:
-			actorIsLocal = PlayerIsLocal(e.u.GunReload.PlayerUID);
+			actorIsLocal = PlayerIsLocal(e->u.GunReload.PlayerUID);
 			break;
-		case GAME_EVENT_GUN_STATE: actorUID = e.u.GunState.ActorUID; break;
+		case GAME_EVENT_GUN_STATE: actorUID = e->u.GunState.ActorUID; break;
 		default: break;
 		}
 		if (actorUID >= 0)
@@ -164,20 +247,101 @@ void GameEventsEnqueue(CArray *store, GameEvent e)
 		}
 		if (actorIsLocal)
 		{
-			NetClientSendMsg(&gNetClient, gee.Type, &e.u);
+			NetClientSendMsg(&gNetClient, gee.Type, &e->u);
+		}
+	}
+
+	if (e->Delay > 0)
+	{
+		CArrayPushBack(&store->Delayed, e);
+	}
+	else
+	{
+		GameEventsPush(store, e);
+	}
+}
+static GameEventBlock *GetBlock(const GameEventStore *store, const int idx)
+{
+	return CArrayGet(&store->Blocks, idx);
+}
+static void GameEventsPush(GameEventStore *store, const GameEvent *e)
+{
+	const int size = GameEventSize(e->Type);
+	CASSERT(size <= GAME_EVENT_BLOCK_SIZE, "game event too large");
+	GameEventBlock *b = NULL;
+	if (store->Blocks.size > 0)
+	{
+		b = GetBlock(store, store->WriteBlock);
+		if (b->Size + size > GAME_EVENT_BLOCK_SIZE)
+		{
+			// Out of room; go to the next block
+			store->WriteBlock++;
+			b = NULL;
+		}
+	}
+	if (b == NULL)
+	{
+		if (store->WriteBlock == (int)store->Blocks.size)
+		{
+			GameEventBlock nb;
+			CMALLOC(nb.Data, GAME_EVENT_BLOCK_SIZE);
+			nb.Size = 0;
+			CArrayPushBack(&store->Blocks, &nb);
 		}
+		b = GetBlock(store, store->WriteBlock);
 	}
+	memcpy(b->Data + b->Size, e, size);
+	b->Size += size;
+}
 
-	CArrayPushBack(store, &e);
+void GameEventsTick(GameEventStore *store)
+{
+	for (int i = 0; i < (int)store->Delayed.size;)
+	{
+		GameEvent *e = CArrayGet(&store->Delayed, i);
+		e->Delay--;
+		if (e->Delay < 0)
+		{
+			GameEventsPush(store, e);
+			CArrayDelete(&store->Delayed, i);
+		}
+		else
+		{
+			i++;
+		}
+	}
 }
-static bool EventComplete(const void *elem);
-void GameEventsClear(CArray *store)
+
+const GameEvent *GameEventsNext(GameEventStore *store)
 {
-	CArrayRemoveIf(store, EventComplete);
+	while (store->ReadBlock < (int)store->Blocks.size)
+	{
+		const GameEventBlock *b = GetBlock(store, store->ReadBlock);
+		if (store->ReadPos < b->Size)
+		{
+			const GameEvent *e = (const GameEvent *)(b->Data + store->ReadPos);
+			store->ReadPos += GameEventSize(e->Type);
+			return e;
+		}
+		if (store->ReadBlock >= store->WriteBlock)
+		{
+			break;
+		}
+		store->ReadBlock++;
+		store->ReadPos = 0;
+	}
+	return NULL;
 }
-static bool EventComplete(const void *elem)
+
+void GameEventsClear(GameEventStore *store)
 {
-	return ((const GameEvent *)elem)->Delay < 0;
+	CASSERT(GameEventsNext(store) == NULL, "clearing unhandled game events");
+	CA_FOREACH(GameEventBlock, b, store->Blocks)
+		b->Size = 0;
+	CA_FOREACH_END()
+	store->ReadBlock = 0;
+	store->ReadPos = 0;
+	store->WriteBlock = 0;
 }
 
 GameEvent GameEventNew(GameEventType type)
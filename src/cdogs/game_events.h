@@ -186,13 +186,39 @@ typedef struct
 	} u;
 } GameEvent;
 
-extern CArray gGameEvents;	// of GameEvent
+// Queue of game events
+// Events are packed one after the other into blocks of memory, each only
+// taking up as much space as its own type needs. Blocks are reused once
+// all the events have been handled, so queued events don't move and can
+// be handled in place.
+// Events with a delay are kept separately until they are due.
+#define GAME_EVENT_BLOCK_SIZE (64 * 1024)
+typedef struct
+{
+	char *Data;
+	int Size;	// bytes used
+} GameEventBlock;
+typedef struct
+{
+	CArray Blocks;	// of GameEventBlock
+	int ReadBlock;
+	int ReadPos;
+	int WriteBlock;
+	CArray Delayed;	// of GameEvent
+} GameEventStore;
+extern GameEventStore gGameEvents;
 
 #define GAME_OVER_DELAY (FPS_FRAMELIMIT * 2)
 
-void GameEventsInit(CArray *store);
-void GameEventsTerminate(CArray *store);
-void GameEventsEnqueue(CArray *store, GameEvent e);
-void GameEventsClear(CArray *store);
+void GameEventsInit(GameEventStore *store);
+void GameEventsTerminate(GameEventStore *store);
+void GameEventsEnqueue(GameEventStore *store, const GameEvent *e);
+// Advance delayed events by one tick, queueing those that are due
+void GameEventsTick(GameEventStore *store);
+// Get the next queued event, or NULL if there are none
+// The event stays valid until the store is cleared
+const GameEvent *GameEventsNext(GameEventStore *store);
+// Remove all handled events, reusing their memory
+void GameEventsClear(GameEventStore *store);
 
 GameEvent GameEventNew(GameEventType type);
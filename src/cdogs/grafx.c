@@ -176,6 +176,7 @@ static void AddSupportedGraphicsModes(GraphicsDevice *device)
 static SDL_Texture *CreateTexture(
 	SDL_Renderer *renderer, const SDL_TextureAccess access, const Vec2i res,
 	const SDL_BlendMode blend, const Uint8 alpha);
+static bool CanLockScreen(SDL_Renderer *renderer);
 void GraphicsInitialize(GraphicsDevice *g)
 {
 	if (g->IsInitialized && !g->cachedConfig.RestartFlags)
@@ -224,9 +225,12 @@ void GraphicsInitialize(GraphicsDevice *g)
 			SDL_GetWindowSize(g->window, &windowSize.x, &windowSize.y);
 		}
 		LOG(LM_GFX, LL_DEBUG, "destroying previous renderer");
+		GraphicsUnlockScreen(g);
 		SDL_DestroyTexture(g->screen);
-		SDL_DestroyTexture(g->bkg);
-		SDL_DestroyTexture(g->brightnessOverlay);
+		if (g->brightnessOverlay != NULL)
+		{
+			SDL_DestroyTexture(g->brightnessOverlay);
+		}
 		SDL_DestroyRenderer(g->renderer);
 		SDL_FreeFormat(g->Format);
 		SDL_DestroyWindow(g->window);
@@ -265,9 +269,12 @@ void GraphicsInitialize(GraphicsDevice *g)
 	{
 		if (!initRenderer)
 		{
+			GraphicsUnlockScreen(g);
 			SDL_DestroyTexture(g->screen);
-			SDL_DestroyTexture(g->bkg);
-			SDL_DestroyTexture(g->brightnessOverlay);
+			if (g->brightnessOverlay != NULL)
+			{
+				SDL_DestroyTexture(g->brightnessOverlay);
+			}
 		}
 
 		// Set render scale mode
@@ -299,41 +306,43 @@ void GraphicsInitialize(GraphicsDevice *g)
 			return;
 		}
 
-		CFREE(g->buf);
-		CCALLOC(g->buf, GraphicsGetMemSize(&g->cachedConfig));
-		g->bkg = CreateTexture(
-			g->renderer, SDL_TEXTUREACCESS_STATIC, Vec2iNew(w, h),
-			SDL_BLENDMODE_NONE, 255);
-		if (g->bkg == NULL)
-		{
-			return;
-		}
+		CFREE(g->bufOwn);
+		CCALLOC(g->bufOwn, GraphicsGetMemSize(&g->cachedConfig));
+		g->buf = g->bufOwn;
+		GraphicsSetBackground(g, NULL);
+		g->canLockScreen = CanLockScreen(g->renderer);
+		GraphicsLockScreen(g);
 	}
 
 	if (initBrightness)
 	{
-		if (!initRenderer && !initTextures)
+		if (!initRenderer && !initTextures && g->brightnessOverlay != NULL)
 		{
 			SDL_DestroyTexture(g->brightnessOverlay);
 		}
+		g->brightnessOverlay = NULL;
 
 		const int brightness = ConfigGetInt(&gConfig, "Graphics.Brightness");
-		// Alpha is approximately 50% max
-		const Uint8 alpha = (Uint8)(brightness > 0 ? brightness : -brightness) * 13;
-		g->brightnessOverlay = CreateTexture(
-			g->renderer, SDL_TEXTUREACCESS_STATIC, Vec2iNew(w, h),
-			SDL_BLENDMODE_BLEND, alpha);
-		if (g->brightnessOverlay == NULL)
+		g->cachedConfig.Brightness = brightness;
+		// Neutral brightness needs no overlay pass at all
+		if (brightness != 0)
 		{
-			return;
+			// Alpha is approximately 50% max
+			const Uint8 alpha = (Uint8)(brightness > 0 ? brightness : -brightness) * 13;
+			g->brightnessOverlay = CreateTexture(
+				g->renderer, SDL_TEXTUREACCESS_STATIC, Vec2iNew(w, h),
+				SDL_BLENDMODE_BLEND, alpha);
+			if (g->brightnessOverlay == NULL)
+			{
+				return;
+			}
+			const color_t overlayColour = brightness > 0 ? colorWhite : colorBlack;
+			DrawRectangle(g, Vec2iZero(), g->cachedConfig.Res, overlayColour, 0);
+			SDL_UpdateTexture(
+				g->brightnessOverlay, NULL, g->buf,
+				g->cachedConfig.Res.x * sizeof(Uint32));
+			memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 		}
-		const color_t overlayColour = brightness > 0 ? colorWhite : colorBlack;
-		DrawRectangle(g, Vec2iZero(), g->cachedConfig.Res, overlayColour, 0);
-		SDL_UpdateTexture(
-			g->brightnessOverlay, NULL, g->buf,
-			g->cachedConfig.Res.x * sizeof(Uint32));
-		memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
-		g->cachedConfig.Brightness = brightness;
 	}
 
 	g->IsInitialized = true;
@@ -370,14 +379,91 @@ void GraphicsTerminate(GraphicsDevice *g)
 	debug(D_NORMAL, "Shutting down video...\n");
 	CArrayTerminate(&g->validModes);
 	SDL_FreeSurface(g->icon);
+	GraphicsUnlockScreen(g);
 	SDL_DestroyTexture(g->screen);
-	SDL_DestroyTexture(g->bkg);
-	SDL_DestroyTexture(g->brightnessOverlay);
+	if (g->brightnessOverlay != NULL)
+	{
+		SDL_DestroyTexture(g->brightnessOverlay);
+	}
 	SDL_DestroyRenderer(g->renderer);
 	SDL_FreeFormat(g->Format);
 	SDL_DestroyWindow(g->window);
 	SDL_VideoQuit();
-	CFREE(g->buf);
+	CFREE(g->bufOwn);
+	CFREE(g->bkg);
+}
+
+static bool CanLockScreen(SDL_Renderer *renderer)
+{
+	// Only the software renderer hands out the texture's own pixels on lock,
+	// so that they survive between frames; other backends give write-only
+	// staging memory, which would break blending and partial redraws
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) != 0)
+	{
+		return false;
+	}
+	return strcmp(info.name, "software") == 0;
+}
+
+void GraphicsLockScreen(GraphicsDevice *g)
+{
+	if (!g->canLockScreen || g->screenLocked)
+	{
+		return;
+	}
+	void *pixels;
+	int pitch;
+	if (SDL_LockTexture(g->screen, NULL, &pixels, &pitch) != 0)
+	{
+		LOG(LM_GFX, LL_WARN, "cannot lock screen texture: %s",
+			SDL_GetError());
+		g->canLockScreen = false;
+		g->buf = g->bufOwn;
+		return;
+	}
+	if (pitch != g->cachedConfig.Res.x * (int)sizeof(Uint32))
+	{
+		SDL_UnlockTexture(g->screen);
+		g->canLockScreen = false;
+		g->buf = g->bufOwn;
+		return;
+	}
+	// Carry over whatever was drawn before the switch
+	if (g->buf != pixels)
+	{
+		memcpy(pixels, g->buf, GraphicsGetMemSize(&g->cachedConfig));
+	}
+	g->buf = pixels;
+	g->screenLocked = true;
+}
+
+void GraphicsUnlockScreen(GraphicsDevice *g)
+{
+	if (!g->screenLocked)
+	{
+		return;
+	}
+	SDL_UnlockTexture(g->screen);
+	g->screenLocked = false;
+}
+
+void GraphicsSetBackground(GraphicsDevice *g, const Uint32 *pixels)
+{
+	CFREE(g->bkg);
+	g->bkg = NULL;
+	if (pixels == NULL)
+	{
+		return;
+	}
+	// The background used to be its own opaque layer; force alpha so that
+	// it still covers the clear colour once merged into the frame
+	const int size = GraphicsGetScreenSize(&g->cachedConfig);
+	CMALLOC(g->bkg, size * sizeof(Uint32));
+	for (int i = 0; i < size; i++)
+	{
+		g->bkg[i] = pixels[i] | g->Format->Amask;
+	}
 }
 
 int GraphicsGetScreenSize(GraphicsConfig *config)
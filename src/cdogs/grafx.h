@@ -95,8 +95,15 @@ typedef struct
 	CArray validModes;	// of Vec2i, w x h
 	int modeIndex;
 	BlitClipping clipping;
+	// Draw target; points into the locked screen texture when the renderer
+	// supports it, otherwise to bufOwn which is uploaded on flip
 	Uint32 *buf;
-	SDL_Texture *bkg;
+	Uint32 *bufOwn;
+	bool canLockScreen;
+	bool screenLocked;
+	// Opaque copy of the static background, or NULL for a blank one
+	Uint32 *bkg;
+	// NULL when brightness is neutral
 	SDL_Texture *brightnessOverlay;
 } GraphicsDevice;
 
@@ -105,6 +112,9 @@ extern GraphicsDevice gGraphicsDevice;
 void GraphicsInit(GraphicsDevice *device, Config *c);
 void GraphicsInitialize(GraphicsDevice *g);
 void GraphicsTerminate(GraphicsDevice *g);
+void GraphicsLockScreen(GraphicsDevice *g);
+void GraphicsUnlockScreen(GraphicsDevice *g);
+void GraphicsSetBackground(GraphicsDevice *g, const Uint32 *pixels);
 int GraphicsGetScreenSize(GraphicsConfig *config);
 int GraphicsGetMemSize(GraphicsConfig *config);
 void GraphicsConfigSet(
@@ -66,19 +66,49 @@ void GrafxDrawBackground(
 
 	if (!HSVEquals(tint, tintNone))
 	{
-		Vec2i v;
-		for (v.y = 0; v.y < g->cachedConfig.Res.y; v.y++)
+		ColorTintTable table;
+		ColorTintTableInit(&table, tint);
+		Uint32 *p = g->buf;
+		const int size = g->cachedConfig.Res.x * g->cachedConfig.Res.y;
+		for (int i = 0; i < size; i++, p++)
 		{
-			for (v.x = 0; v.x < g->cachedConfig.Res.x; v.x++)
-			{
-				DrawPointTint(g, v, tint);
-			}
+			*p = COLOR2PIXEL(ColorTintTableApply(&table, PIXEL2COLOR(*p)));
 		}
 	}
-	SDL_UpdateTexture(
-		g->bkg, NULL, g->buf, g->cachedConfig.Res.x * sizeof(Uint32));
+	GraphicsSetBackground(g, g->buf);
+	GraphicsClear(g);
+}
+
+void GrafxDrawBackgroundArea(
+	GraphicsDevice *g, DrawBuffer *buffer, Vec2i pos, GrafxDrawExtra *extra,
+	const Rect2i area)
+{
+	const int left = MAX(area.Pos.x, 0);
+	const int top = MAX(area.Pos.y, 0);
+	const int right = MIN(area.Pos.x + area.Size.x, g->cachedConfig.Res.x) - 1;
+	const int bottom =
+		MIN(area.Pos.y + area.Size.y, g->cachedConfig.Res.y) - 1;
+	if (left > right || top > bottom)
+	{
+		return;
+	}
+
+	// Start from the existing background, clear the area and draw into it
+	GraphicsClear(g);
+	for (int y = top; y <= bottom; y++)
+	{
+		memset(
+			g->buf + y * g->cachedConfig.Res.x + left, 0,
+			(right - left + 1) * sizeof *g->buf);
+	}
+	const BlitClipping clip = g->clipping;
+	GraphicsSetBlitClip(g, left, top, right, bottom);
+	DrawBufferSetFromMap(buffer, &gMap, pos, X_TILES);
+	DrawBufferDraw(buffer, Vec2iZero(), extra);
+	g->clipping = clip;
+
+	GraphicsSetBackground(g, g->buf);
 	GraphicsClear(g);
-	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 }
 
 void GrafxRedrawBackground(GraphicsDevice *g, const Vec2i pos)
@@ -121,5 +151,15 @@ void GrafxMakeBackground(
 
 void GraphicsClear(GraphicsDevice *device)
 {
-	memset(device->buf, 0, GraphicsGetMemSize(&device->cachedConfig));
+	// Clearing to the background merges it into the frame in the same pass
+	if (device->bkg == NULL)
+	{
+		memset(device->buf, 0, GraphicsGetMemSize(&device->cachedConfig));
+	}
+	else
+	{
+		memcpy(
+			device->buf, device->bkg,
+			GraphicsGetMemSize(&device->cachedConfig));
+	}
 }
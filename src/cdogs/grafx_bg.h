@@ -39,6 +39,11 @@ typedef struct
 void GrafxDrawBackground(
 	GraphicsDevice *g, DrawBuffer *buffer,
 	HSV tint, Vec2i pos, GrafxDrawExtra *extra);
+// Redraw an untinted background within a screen area only, keeping the
+// rest of it as it was
+void GrafxDrawBackgroundArea(
+	GraphicsDevice *g, DrawBuffer *buffer, Vec2i pos, GrafxDrawExtra *extra,
+	const Rect2i area);
 void GrafxRedrawBackground(GraphicsDevice *g, const Vec2i pos);
 void GrafxMakeBackground(
 	GraphicsDevice *device, DrawBuffer *buffer,
@@ -29,11 +29,12 @@
 
 #include "c_array.h"
 #include "camera.h"
+#include "game_events.h"
 #include "powerup.h"
 
 // TODO: This whole module can be replaced with a event/listener pattern
 void HandleGameEvents(
-	CArray *store,
+	GameEventStore *store,
 	Camera *camera,
 	PowerupSpawner *healthSpawner,
 	CArray *ammoSpawners);
@@ -69,6 +69,7 @@
 #include "keyboard.h"
 #include "pics.h"
 #include "sounds.h"
+#include "file_writer.h"
 #include "files.h"
 #include "utils.h"
 
@@ -234,41 +235,46 @@ void DisplayTodaysHighScores(GraphicsDevice *graphics)
 #define MAGIC        4711
 #define SCORES_FILE "scores.dat"
 
+// Append a value to the scores buffer, returning the end of the value
+static char *ScoresWrite(char *p, const void *v, const size_t size)
+{
+	memcpy(p, v, size);
+	return p + size;
+}
 void SaveHighScores(void)
 {
 	int magic;
-	FILE *f;
 	time_t t;
 	struct tm *tp;
 
 	debug(D_NORMAL, "begin\n");
 
-	f = fopen(GetConfigFilePath(SCORES_FILE), "wb");
-	if (f != NULL) {
-		magic = MAGIC;
+	// Copy the scores into a buffer that is written in the background
+	const size_t size =
+		sizeof magic * 4 + sizeof allTimeHigh + sizeof todaysHigh;
+	char *data;
+	CMALLOC(data, size);
+	char *p = data;
 
-		fwrite(&magic, sizeof(magic), 1, f);
-		fwrite(allTimeHigh, sizeof(allTimeHigh), 1, f);
+	magic = MAGIC;
+	p = ScoresWrite(p, &magic, sizeof magic);
+	p = ScoresWrite(p, &allTimeHigh, sizeof allTimeHigh);
 
-		t = time(NULL);
-		tp = localtime(&t);
-		debug(D_NORMAL, "time now, y: %d m: %d d: %d\n", tp->tm_year, tp->tm_mon, tp->tm_mday);
-
-		magic = tp->tm_year;
-		fwrite(&magic, sizeof(magic), 1, f);
-		magic = tp->tm_mon;
-		fwrite(&magic, sizeof(magic), 1, f);
-		magic = tp->tm_mday;
-		fwrite(&magic, sizeof(magic), 1, f);
+	t = time(NULL);
+	tp = localtime(&t);
+	debug(D_NORMAL, "time now, y: %d m: %d d: %d\n", tp->tm_year, tp->tm_mon, tp->tm_mday);
 
-		debug(D_NORMAL, "writing today's high: %d\n", todaysHigh[0].score);
-		fwrite(todaysHigh, sizeof(todaysHigh), 1, f);
+	magic = tp->tm_year;
+	p = ScoresWrite(p, &magic, sizeof magic);
+	magic = tp->tm_mon;
+	p = ScoresWrite(p, &magic, sizeof magic);
+	magic = tp->tm_mday;
+	p = ScoresWrite(p, &magic, sizeof magic);
 
-		fclose(f);
+	debug(D_NORMAL, "writing today's high: %d\n", todaysHigh[0].score);
+	p = ScoresWrite(p, &todaysHigh, sizeof todaysHigh);
 
-		debug(D_NORMAL, "saved high scores\n");
-	} else
-		printf("Unable to open %s\n", SCORES_FILE);
+	FileWriterSave(&gFileWriter, GetConfigFilePath(SCORES_FILE), data, size);
 }
 
 void LoadHighScores(void)
@@ -509,8 +509,7 @@ static void DrawObjectiveCompass(
 		for (tilePos.x = 0; tilePos.x < map->Size.x; tilePos.x++)
 		{
 			Tile *tile = MapGetTile(map, tilePos);
-			CA_FOREACH(ThingId, tid, tile->things)
-				TTileItem *ti = ThingIdGetTileItem(tid);
+			TILE_FOREACH_THING(tile, ti)
 				if (!(ti->flags & TILEITEM_OBJECTIVE))
 				{
 					continue;
@@ -528,7 +527,7 @@ static void DrawObjectiveCompass(
 				}
 				DrawCompassArrow(
 					g, r, Vec2iNew(ti->x, ti->y), playerPos, o->color, NULL);
-			CA_FOREACH_END()
+			TILE_FOREACH_THING_END()
 		}
 	}
 }
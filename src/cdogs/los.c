@@ -150,8 +150,7 @@ void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 	{
 		for (end.x = origin.x; end.x < origin.x + perimSize.x; end.x++)
 		{
-			const Tile *tile = MapGetTile(map, end);
-			if (!tile || !(tile->flags & MAPTILE_NO_SEE))
+			if (!(MapGetTileFlags(map, end) & MAPTILE_NO_SEE))
 			{
 				continue;
 			}
@@ -177,7 +176,7 @@ void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 				&e.u.ExploreTiles, &run, end,
 				*((bool *)CArrayGet(&map->LOS.Explored, end.y * map->Size.x + end.x))))
 			{
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 				e.u.ExploreTiles.Runs_count = 0;
 				e.u.ExploreTiles.Runs[0].Run = 0;
 				run = false;
@@ -186,7 +185,7 @@ void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 	}
 	if (e.u.ExploreTiles.Runs_count > 0)
 	{
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	CArrayFillZero(&map->LOS.Explored);
 }
@@ -202,14 +201,13 @@ static void SetLOSVisible(Map *map, const Vec2i pos, const bool explore)
 	}
 	// Mark any actors on this tile as visible
 	// This affects some AI
-	CA_FOREACH(ThingId, tid, t->things)
-		const TTileItem *ti = ThingIdGetTileItem(tid);
+	TILE_FOREACH_THING(t, ti)
 		if (ti->kind == KIND_CHARACTER)
 		{
 			TActor *a = CArrayGet(&gActors, ti->id);
 			a->flags |= FLAGS_VISIBLE;
 		}
-	CA_FOREACH_END()
+	TILE_FOREACH_THING_END()
 }
 static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos)
 {
@@ -217,11 +215,10 @@ static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos)
 	// Check sight range
 	if (DistanceSquared(lData->Center, pos) >= lData->SightRange2) return true;
 	// Check map range
-	const Tile *t = MapGetTile(lData->Map, pos);
-	if (t == NULL) return true;
+	if (!MapIsTileIn(lData->Map, pos)) return true;
 	SetLOSVisible(lData->Map, pos, lData->Explore);
 	// Check if this tile is an obstruction
-	return t->flags & MAPTILE_NO_SEE;
+	return MapGetTileFlags(lData->Map, pos) & MAPTILE_NO_SEE;
 }
 static bool IsTileVisibleNonObstruction(Map *map, const Vec2i pos);
 static void SetObstructionVisible(
@@ -242,9 +239,9 @@ static void SetObstructionVisible(
 }
 static bool IsTileVisibleNonObstruction(Map *map, const Vec2i pos)
 {
-	const Tile *t = MapGetTile(map, pos);
-	if (t == NULL) return false;
-	return !(t->flags & MAPTILE_NO_SEE) && LOSTileIsVisible(map, pos);
+	if (!MapIsTileIn(map, pos)) return false;
+	return !(MapGetTileFlags(map, pos) & MAPTILE_NO_SEE) &&
+		LOSTileIsVisible(map, pos);
 }
 
 bool LOSAddRun(
@@ -54,6 +54,7 @@
 
 #include "algorithms.h"
 #include "ammo.h"
+#include "automap.h"
 #include "collision/collision.h"
 #include "config.h"
 #include "door.h"
@@ -124,6 +125,75 @@ Tile *MapGetTile(Map *map, Vec2i pos)
 	}
 	return CArrayGet(&map->Tiles, pos.y * map->Size.x + pos.x);
 }
+int MapGetTileFlags(const Map *map, const Vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= map->Size.x || pos.y < 0 || pos.y >= map->Size.y)
+	{
+		return MAPTILE_NO_WALK | MAPTILE_IS_NOTHING;
+	}
+	return ((const unsigned short *)map->TileFlags.data)[
+		pos.y * map->Size.x + pos.x];
+}
+static void FreeTilesUpdate(Map *map, const int idx, const int flags);
+void MapSetTileFlags(Map *map, const Vec2i pos, const int flags)
+{
+	MapGetTile(map, pos)->flags = flags;
+	AutomapInvalidateTile(pos);
+	WatchesOnTileChanged(pos);
+	const int idx = pos.y * map->Size.x + pos.x;
+	*(unsigned short *)CArrayGet(&map->TileFlags, idx) = (unsigned short)flags;
+	// Free tiles are indexed once the map has been built
+	if (map->FreeTileSlots.size > 0)
+	{
+		FreeTilesUpdate(map, idx, flags);
+	}
+}
+static void FreeTilesUpdate(Map *map, const int idx, const int flags)
+{
+	int *slot = CArrayGet(&map->FreeTileSlots, idx);
+	const bool isFree = !(flags & MAPTILE_NO_WALK);
+	const Vec2i pos = Vec2iNew(idx % map->Size.x, idx / map->Size.x);
+	const MapRegion region = (IMapGet(map, pos) & MAP_ACCESSBITS) ?
+		MAP_REGION_LOCKED : MAP_REGION_UNLOCKED;
+	// Remove tiles that are no longer free, or whose region has changed,
+	// e.g. when the editor sets a door's key
+	if (*slot >= 0 && (!isFree || (MapRegion)(*slot & 1) != region))
+	{
+		// Swap the last free tile into the removed one's place
+		CArray *freeTiles = &map->FreeTiles[*slot & 1];
+		const int i = *slot >> 1;
+		const int last = *(const int *)CArrayGet(
+			freeTiles, (int)freeTiles->size - 1);
+		*(int *)CArrayGet(freeTiles, i) = last;
+		*(int *)CArrayGet(&map->FreeTileSlots, last) = *slot;
+		CArrayDelete(freeTiles, (int)freeTiles->size - 1);
+		*slot = -1;
+	}
+	if (isFree && *slot < 0)
+	{
+		CArrayPushBack(&map->FreeTiles[region], &idx);
+		*slot = ((int)map->FreeTiles[region].size - 1) << 1 | region;
+	}
+}
+static void MapSyncTileFlags(Map *map)
+{
+	CA_FOREACH(const Tile, t, map->Tiles)
+		*(unsigned short *)CArrayGet(&map->TileFlags, _ca_index) =
+			(unsigned short)t->flags;
+	CA_FOREACH_END()
+
+	// Index the free tiles
+	for (MapRegion r = MAP_REGION_UNLOCKED; r < MAP_REGION_ANY; r++)
+	{
+		CArrayClear(&map->FreeTiles[r]);
+	}
+	CArrayClear(&map->FreeTileSlots);
+	const int noSlot = -1;
+	CArrayResize(&map->FreeTileSlots, map->Tiles.size, &noSlot);
+	CA_FOREACH(const Tile, t, map->Tiles)
+		FreeTilesUpdate(map, _ca_index, t->flags);
+	CA_FOREACH_END()
+}
 
 bool MapIsTileIn(const Map *map, const Vec2i pos)
 {
@@ -157,6 +227,7 @@ static Tile *MapGetTileOfItem(Map *map, TTileItem *t)
 }
 
 static void AddItemToTile(TTileItem *t, Tile *tile);
+static void OnTileItemsChanged(const TTileItem *t, const Vec2i tilePos);
 bool MapTryMoveTileItem(Map *map, TTileItem *t, Vec2i pos)
 {
 	// Check if we can move to new position
@@ -184,8 +255,17 @@ bool MapTryMoveTileItem(Map *map, TTileItem *t, Vec2i pos)
 	t->x = pos.x;
 	t->y = pos.y;
 	AddItemToTile(t, MapGetTile(map, t2));
+	OnTileItemsChanged(t, t2);
 	return true;
 }
+static void OnTileItemsChanged(const TTileItem *t, const Vec2i tilePos)
+{
+	// Particles don't affect whether tiles are clear
+	if (t->kind != KIND_PARTICLE)
+	{
+		WatchesOnTileChanged(tilePos);
+	}
+}
 static void AddItemToTile(TTileItem *t, Tile *tile)
 {
 	ThingId tid;
@@ -193,7 +273,22 @@ static void AddItemToTile(TTileItem *t, Tile *tile)
 	tid.Kind = t->kind;
 	CASSERT(tid.Id >= 0, "invalid ThingId");
 	CASSERT(tid.Kind >= 0 && tid.Kind <= KIND_PICKUP, "unknown thing kind");
-	CArrayPushBack(&tile->things, &tid);
+	// Append to the tile's list, so things stay in the order they arrived
+	t->tilePrev = tile->thingsLast;
+	t->tileNext.Id = -1;
+	if (tile->thingsLast.Id >= 0)
+	{
+		ThingIdGetTileItem(&tile->thingsLast)->tileNext = tid;
+	}
+	else
+	{
+		tile->things = tid;
+	}
+	tile->thingsLast = tid;
+}
+static bool ThingIdIs(const ThingId tid, const TTileItem *t)
+{
+	return tid.Id == t->id && tid.Kind == t->kind;
 }
 
 void MapRemoveTileItem(Map *map, TTileItem *t)
@@ -203,21 +298,80 @@ void MapRemoveTileItem(Map *map, TTileItem *t)
 		return;
 	}
 	Tile *tile = MapGetTileOfItem(map, t);
-	CA_FOREACH(ThingId, tid, tile->things)
-		if (tid->Id == t->id && tid->Kind == t->kind)
+	// Check the links around the item, so that we don't have to walk the
+	// whole list to find it
+	if (t->tilePrev.Id >= 0)
+	{
+		TTileItem *prev = ThingIdGetTileItem(&t->tilePrev);
+		CASSERT(ThingIdIs(prev->tileNext, t), "Did not find element to delete");
+		prev->tileNext = t->tileNext;
+	}
+	else
+	{
+		CASSERT(ThingIdIs(tile->things, t), "Did not find element to delete");
+		tile->things = t->tileNext;
+	}
+	if (t->tileNext.Id >= 0)
+	{
+		ThingIdGetTileItem(&t->tileNext)->tilePrev = t->tilePrev;
+	}
+	else
+	{
+		CASSERT(
+			ThingIdIs(tile->thingsLast, t), "Did not find element to delete");
+		tile->thingsLast = t->tilePrev;
+	}
+	t->tilePrev.Id = -1;
+	t->tileNext.Id = -1;
+	OnTileItemsChanged(t, Vec2iToTile(Vec2iNew(t->x, t->y)));
+}
+
+bool MapTryGetRandomFreeTile(
+	const Map *map, const MapRegion region, Vec2i *tile)
+{
+	const CArray *freeTiles;
+	int i;
+	if (region == MAP_REGION_ANY)
+	{
+		const int numUnlocked = (int)map->FreeTiles[MAP_REGION_UNLOCKED].size;
+		const int n = numUnlocked + (int)map->FreeTiles[MAP_REGION_LOCKED].size;
+		if (n == 0)
 		{
-			CArrayDelete(&tile->things, _ca_index);
-			return;
+			return false;
 		}
-	CA_FOREACH_END()
-	CASSERT(false, "Did not find element to delete");
+		i = rand() % n;
+		freeTiles = &map->FreeTiles[MAP_REGION_UNLOCKED];
+		if (i >= numUnlocked)
+		{
+			freeTiles = &map->FreeTiles[MAP_REGION_LOCKED];
+			i -= numUnlocked;
+		}
+	}
+	else
+	{
+		freeTiles = &map->FreeTiles[region];
+		if (freeTiles->size == 0)
+		{
+			return false;
+		}
+		i = rand() % (int)freeTiles->size;
+	}
+	const int idx = *(const int *)CArrayGet(freeTiles, i);
+	*tile = Vec2iNew(idx % map->Size.x, idx / map->Size.x);
+	return true;
 }
-
-static Vec2i GuessPixelCoords(Map *map)
+Vec2i MapGetRandomFreePos(const Map *map, const MapRegion region)
 {
+	Vec2i tile;
+	if (!MapTryGetRandomFreeTile(map, region, &tile))
+	{
+		return Vec2iNew(
+			rand() % (map->Size.x * TILE_WIDTH),
+			rand() % (map->Size.y * TILE_HEIGHT));
+	}
 	return Vec2iNew(
-		rand() % (map->Size.x * TILE_WIDTH),
-		rand() % (map->Size.y * TILE_HEIGHT));
+		tile.x * TILE_WIDTH + rand() % TILE_WIDTH,
+		tile.y * TILE_HEIGHT + rand() % TILE_HEIGHT);
 }
 
 unsigned short IMapGet(const Map *map, const Vec2i pos)
@@ -421,7 +575,7 @@ void MapPlaceCollectible(
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = ObjectiveToTileItem(objective);
 	e.u.AddPickup.Pos = Vec2i2Net(realPos);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 static int MapTryPlaceCollectible(
 	Map *map, const Mission *mission, const struct MissionOptions *mo,
@@ -432,10 +586,12 @@ static int MapTryPlaceCollectible(
 		(o->Flags & OBJECTIVE_HIACCESS) && MapHasLockedRooms(map);
 	const bool noaccess = o->Flags & OBJECTIVE_NOACCESS;
 	int i = (noaccess || hasLockedRooms) ? 1000 : 100;
+	const MapRegion region = hasLockedRooms ? MAP_REGION_LOCKED :
+		(noaccess ? MAP_REGION_UNLOCKED : MAP_REGION_ANY);
 
 	while (i)
 	{
-		Vec2i v = GuessPixelCoords(map);
+		Vec2i v = MapGetRandomFreePos(map, region);
 		Vec2i size = Vec2iNew(COLLECTABLE_W, COLLECTABLE_H);
 		if (!IsCollisionWithWall(v, size))
 		{
@@ -455,7 +611,7 @@ Vec2i MapGenerateFreePosition(Map *map, Vec2i size)
 {
 	for (int i = 0; i < 100; i++)
 	{
-		Vec2i v = GuessPixelCoords(map);
+		Vec2i v = MapGetRandomFreePos(map, MAP_REGION_ANY);
 		if (!IsCollisionWithWall(v, size))
 		{
 			return v;
@@ -507,7 +663,7 @@ void MapPlaceKey(
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = 0;
 	e.u.AddPickup.Pos = Vec2i2Net(Vec2iCenterOfTile(pos));
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 static void MapPlaceCard(Map *map, int keyIndex, int map_access)
@@ -612,7 +768,13 @@ void MapTerminate(Map *map)
 		}
 	}
 	CArrayTerminate(&map->Tiles);
+	CArrayTerminate(&map->TileFlags);
 	CArrayTerminate(&map->iMap);
+	for (MapRegion r = MAP_REGION_UNLOCKED; r < MAP_REGION_ANY; r++)
+	{
+		CArrayTerminate(&map->FreeTiles[r]);
+	}
+	CArrayTerminate(&map->FreeTileSlots);
 	LOSTerminate(&map->LOS);
 	PathCacheTerminate(&gPathCache);
 }
@@ -624,12 +786,19 @@ void MapLoad(
 	// Init map
 	memset(map, 0, sizeof *map);
 	CArrayInit(&map->Tiles, sizeof(Tile));
+	CArrayInit(&map->TileFlags, sizeof(unsigned short));
 	CArrayInit(&map->iMap, sizeof(unsigned short));
+	for (MapRegion r = MAP_REGION_UNLOCKED; r < MAP_REGION_ANY; r++)
+	{
+		CArrayInit(&map->FreeTiles[r], sizeof(int));
+	}
+	CArrayInit(&map->FreeTileSlots, sizeof(int));
 	const Mission *mission = mo->missionData;
 	map->Size = mission->Size;
 	LOSInit(map, map->Size);
 	CArrayInit(&map->triggers, sizeof(Trigger *));
 	PathCacheInit(&gPathCache, map);
+	AutomapInvalidate();
 
 	Vec2i v;
 	for (v.y = 0; v.y < map->Size.y; v.y++)
@@ -640,6 +809,8 @@ void MapLoad(
 			unsigned short tI = MAP_FLOOR;
 			TileInit(&t);
 			CArrayPushBack(&map->Tiles, &t);
+			const unsigned short flags = (unsigned short)t.flags;
+			CArrayPushBack(&map->TileFlags, &flags);
 			CArrayPushBack(&map->iMap, &tI);
 		}
 	}
@@ -662,6 +833,7 @@ void MapLoad(
 
 	MapSetupTilesAndWalls(map, mission);
 	MapSetupDoors(map, mission);
+	MapSyncTileFlags(map);
 
 	if (mission->Type == MAPTYPE_CLASSIC)
 	{
@@ -694,12 +866,14 @@ void MapLoad(
 	{
 		for (v.x = 0; v.x < map->Size.x; v.x++)
 		{
-			if (!(MapGetTile(map, v)->flags & MAPTILE_NO_WALK))
+			if (!(MapGetTileFlags(map, v) & MAPTILE_NO_WALK))
 			{
 				map->NumExplorableTiles++;
 			}
 		}
 	}
+
+	PathCacheBuild(&gPathCache);
 }
 
 static void AddObjectives(Map *map, const struct MissionOptions *mo);
@@ -840,21 +1014,13 @@ bool MapIsTileAreaClear(Map *map, const Vec2i fullPos, const Vec2i size)
 			{
 				continue;
 			}
-			const CArray *tileThings = &MapGetTile(map, dtv)->things;
-			if (tileThings == NULL)
-			{
-				continue;
-			}
-			for (int i = 0; i < (int)tileThings->size; i++)
-			{
-				const TTileItem *ti =
-					ThingIdGetTileItem(CArrayGet(tileThings, i));
+			TILE_FOREACH_THING(MapGetTile(map, dtv), ti)
 				if (AABBOverlap(
 						realPos, Vec2iNew(ti->x, ti->y), size, ti->size))
 				{
 					return false;
 				}
-			}
+			TILE_FOREACH_THING_END()
 		}
 	}
 
@@ -864,15 +1030,21 @@ bool MapIsTileAreaClear(Map *map, const Vec2i fullPos, const Vec2i size)
 void MapMarkAsVisited(Map *map, Vec2i pos)
 {
 	Tile *t = MapGetTile(map, pos);
-	if (!t->isVisited && !(t->flags & MAPTILE_NO_WALK))
+	if (t->isVisited)
+	{
+		return;
+	}
+	if (!(t->flags & MAPTILE_NO_WALK))
 	{
 		map->tilesSeen++;
 	}
 	t->isVisited = true;
+	AutomapInvalidateTile(pos);
 }
 
 void MapMarkAllAsVisited(Map *map)
 {
+	AutomapInvalidate();
 	Vec2i pos;
 	for (pos.y = 0; pos.y < map->Size.y; pos.y++)
 	{
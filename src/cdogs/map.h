@@ -91,14 +91,31 @@ typedef struct
 	CArray Explored; // of bool
 } LineOfSight;
 
+// Areas of the map to randomly place things in
+typedef enum
+{
+	MAP_REGION_UNLOCKED,	// outside locked rooms
+	MAP_REGION_LOCKED,		// inside locked rooms
+	MAP_REGION_ANY
+} MapRegion;
+
 typedef struct
 {
 	CArray Tiles;	// of Tile
 	Vec2i Size;
+	// Copy of every tile's flags, packed for collision and LOS checks
+	// Use MapSetTileFlags to keep in sync with the tiles
+	CArray TileFlags;	// of unsigned short
 
 	// internal data structure to help build the map
 	CArray iMap;	// of unsigned short
 
+	// Indices of walkable tiles per region, for random placement
+	// Use MapSetTileFlags to keep in sync with the tiles
+	CArray FreeTiles[MAP_REGION_ANY];	// of int
+	// Per tile, its index in FreeTiles << 1 | region, or -1 if not walkable
+	CArray FreeTileSlots;	// of int
+
 	LineOfSight LOS;
 
 	CArray triggers;	// of Trigger *; owner
@@ -118,6 +135,9 @@ extern Map gMap;
 unsigned short GetAccessMask(int k);
 
 Tile *MapGetTile(Map *map, Vec2i pos);
+// Out-of-map tiles are treated as nothing, like TileNone
+int MapGetTileFlags(const Map *map, const Vec2i pos);
+void MapSetTileFlags(Map *map, const Vec2i pos, const int flags);
 bool MapIsTileIn(const Map *map, const Vec2i pos);
 bool MapIsRealPosIn(const Map *map, const Vec2i realPos);
 bool MapIsTileInExit(const Map *map, const TTileItem *ti);
@@ -157,6 +177,12 @@ bool MapTileIsUnexplored(Map *map, Vec2i tile);
 unsigned short IMapGet(const Map *map, const Vec2i pos);
 void IMapSet(Map *map, Vec2i pos, unsigned short v);
 Vec2i MapGenerateFreePosition(Map *map, Vec2i size);
+// Pick a uniformly random walkable tile in the region
+bool MapTryGetRandomFreeTile(
+	const Map *map, const MapRegion region, Vec2i *tile);
+// Random real position on a walkable tile in the region, or anywhere on the
+// map if there are none
+Vec2i MapGetRandomFreePos(const Map *map, const MapRegion region);
 bool MapTryPlaceOneObject(
 	Map *map, const Vec2i v, const MapObject *mo, const int extraFlags,
 	const bool isStrictMode);
@@ -32,6 +32,7 @@
 
 #include "ammo.h"
 #include "character_class.h"
+#include "file_writer.h"
 #include "files.h"
 #include "json_utils.h"
 #include "log.h"
@@ -259,9 +260,8 @@ end:
 
 
 static json_t *SaveMissions(CArray *a);
-int MapArchiveSave(const char *filename, CampaignSetting *c)
+void MapArchiveSave(const char *filename, CampaignSetting *c)
 {
-	int res = 1;
 	json_t *root = NULL;
 
 	char relbuf[CDOGS_PATH_MAX];
@@ -288,31 +288,14 @@ int MapArchiveSave(const char *filename, CampaignSetting *c)
 	AddIntPair(root, "Missions", c->Missions.size);
 	char buf2[CDOGS_PATH_MAX];
 	sprintf(buf2, "%s/campaign.json", buf);
-	if (!TrySaveJSONFile(root, buf2))
-	{
-		res = 0;
-		goto bail;
-	}
+	FileWriterSaveJSON(&gFileWriter, buf2, root);
 
-	json_free_value(&root);
 	root = json_new_object();
 	json_insert_pair_into_object(root, "Missions", SaveMissions(&c->Missions));
 	sprintf(buf2, "%s/missions.json", buf);
-	if (!TrySaveJSONFile(root, buf2))
-	{
-		res = 0;
-		goto bail;
-	}
+	FileWriterSaveJSON(&gFileWriter, buf2, root);
 
-	if (!CharacterSave(&c->characters, buf))
-	{
-		res = 0;
-		goto bail;
-	}
-
-bail:
-	json_free_value(&root);
-	return res;
+	CharacterSave(&c->characters, buf);
 }
 
 static json_t *SaveObjectives(CArray *a);
@@ -34,4 +34,6 @@
 int MapNewScanArchive(
 	const char *filename, char **title, int *numMissions);
 int MapNewLoadArchive(const char *filename, CampaignSetting *c);
-int MapArchiveSave(const char *filename, CampaignSetting *c);
+// The files are written in the background by gFileWriter; flush it to
+// find out whether they were written successfully
+void MapArchiveSave(const char *filename, CampaignSetting *c);
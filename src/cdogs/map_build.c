@@ -141,6 +141,7 @@ static void MapSetupTile(Map *map, const Vec2i pos, const Mission *m)
 	{
 		return;
 	}
+	int flags = t->flags;
 	switch (IMapGet(map, pos) & MAP_MASKACCESS)
 	{
 	case MAP_FLOOR:
@@ -153,7 +154,7 @@ static void MapSetupTile(Map *map, const Vec2i pos, const Mission *m)
 		{
 			// Normal floor tiles can be replaced randomly with
 			// special floor tiles such as drainage
-			t->flags |= MAPTILE_IS_NORMAL_FLOOR;
+			flags |= MAPTILE_IS_NORMAL_FLOOR;
 		}
 		break;
 
@@ -169,17 +170,20 @@ static void MapSetupTile(Map *map, const Vec2i pos, const Mission *m)
 		t->pic = PicManagerGetMaskedStylePic(
 			&gPicManager, "wall", m->WallStyle, MapGetWallPic(map, pos),
 			m->WallMask, m->AltMask);
-		t->flags =
+		flags =
 			MAPTILE_NO_WALK | MAPTILE_NO_SHOOT |
 			MAPTILE_NO_SEE | MAPTILE_IS_WALL;
 		break;
 
 	case MAP_NOTHING:
 		t->pic = NULL;
-		t->flags =
+		flags =
 			MAPTILE_NO_WALK | MAPTILE_IS_NOTHING;
 		break;
 	}
+	// The editor changes tiles of a loaded map; keep everything that
+	// depends on the flags up to date
+	MapSetTileFlags(map, pos, flags);
 }
 static int W(const Map *map, const int x, const int y);
 static const char *MapGetWallPic(const Map *m, const Vec2i pos)
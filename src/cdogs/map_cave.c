@@ -31,7 +31,9 @@
 #include "map_build.h"
 
 
-static void CaveRep(Map *map, const int r1, const int r2);
+// Padding around the summed-area table; the largest radius counted
+#define SAT_PAD 2
+static void CaveRep(Map *map, const int r1, const int r2, int *sat);
 static void LinkDisconnectedAreas(Map *map);
 static void FixCorridors(Map *map, const int corridorWidth);
 static void PlaceSquares(Map *map, const int squares);
@@ -54,10 +56,16 @@ void MapCaveLoad(
 	// Shuffle
 	CArrayShuffle(&map->iMap);
 	// Repetitions
+	// Summed-area table of walls, reused for each repetition
+	int *sat;
+	CMALLOC(sat,
+		(map->Size.x + SAT_PAD * 2 + 1) * (map->Size.y + SAT_PAD * 2 + 1) *
+		sizeof *sat);
 	for (int i = 0; i < m->u.Cave.Repeat; i++)
 	{
-		CaveRep(map, m->u.Cave.R1, m->u.Cave.R2);
+		CaveRep(map, m->u.Cave.R1, m->u.Cave.R2, sat);
 	}
+	CFREE(sat);
 
 	LinkDisconnectedAreas(map);
 
@@ -70,24 +78,43 @@ void MapCaveLoad(
 // If the number of walls within 1 distance is at least R1, OR
 // if the number of walls within 2 distance is at most R2, then the tile
 // becomes a wall; otherwise it is a floor
-static int CountTilesAround(
-	const Map *map, const Vec2i pos, const int radius,
-	const unsigned short tile);
-static void CaveRep(Map *map, const int r1, const int r2)
+// Walls are counted using a summed-area table of the previous generation,
+// padded by 2 tiles of walls around the map (edges of the map count as
+// walls), so each count is 4 lookups regardless of radius.
+static int CountWallsAround(
+	const int *sat, const int satWidth, const Vec2i pos, const int radius);
+static void CaveRep(Map *map, const int r1, const int r2, int *sat)
 {
-	CArray buf;
-	CArrayInit(&buf, map->iMap.elemSize);
-	const unsigned short floor = MAP_FLOOR;
-	CArrayResize(&buf, map->iMap.size, &floor);
+	const int satWidth = map->Size.x + SAT_PAD * 2 + 1;
+	const int satHeight = map->Size.y + SAT_PAD * 2 + 1;
+	unsigned short *tiles = map->iMap.data;
+	// Build the table; the first row and column are zero
+	memset(sat, 0, satWidth * sizeof *sat);
+	for (int y = 1; y < satHeight; y++)
+	{
+		const int ty = y - 1 - SAT_PAD;
+		int rowSum = 0;
+		sat[y * satWidth] = 0;
+		for (int x = 1; x < satWidth; x++)
+		{
+			const int tx = x - 1 - SAT_PAD;
+			if (tx < 0 || tx >= map->Size.x || ty < 0 || ty >= map->Size.y ||
+				tiles[ty * map->Size.x + tx] == MAP_WALL)
+			{
+				rowSum++;
+			}
+			sat[y * satWidth + x] = sat[(y - 1) * satWidth + x] + rowSum;
+		}
+	}
+	// The table holds the previous generation, so we can update in place
 	Vec2i v;
 	for (v.y = 0; v.y < map->Size.y; v.y++)
 	{
 		for (v.x = 0; v.x < map->Size.x; v.x++)
 		{
-			const int idx = v.x + v.y * map->Size.x;
-			unsigned short *tile = CArrayGet(&buf, idx);
-			if (CountTilesAround(map, v, 1, MAP_WALL) >= r1 ||
-				CountTilesAround(map, v, 2, MAP_WALL) <= r2)
+			unsigned short *tile = &tiles[v.x + v.y * map->Size.x];
+			if (CountWallsAround(sat, satWidth, v, 1) >= r1 ||
+				CountWallsAround(sat, satWidth, v, 2) <= r2)
 			{
 				*tile = MAP_WALL;
 			}
@@ -97,58 +124,74 @@ static void CaveRep(Map *map, const int r1, const int r2)
 			}
 		}
 	}
-	CArrayCopy(&map->iMap, &buf);
-	CArrayTerminate(&buf);
 }
-static int CountTilesAround(
-	const Map *map, const Vec2i pos, const int radius,
-	const unsigned short tile)
+static int CountWallsAround(
+	const int *sat, const int satWidth, const Vec2i pos, const int radius)
 {
-	int c = 0;
-	for (int x = pos.x - radius; x <= pos.x + radius; x++)
-	{
-		for (int y = pos.y - radius; y <= pos.y + radius; y++)
-		{
-			// Also count edge of maps
-			if (x < 0 || x >= map->Size.x || y < 0 || y >= map->Size.y ||
-				IMapGet(map, Vec2iNew(x, y)) == tile)
-			{
-				c++;
-			}
-		}
-	}
-	return c;
+	// Corners of the square, in table coordinates
+	const int x0 = pos.x + SAT_PAD - radius;
+	const int y0 = pos.y + SAT_PAD - radius;
+	const int x1 = pos.x + SAT_PAD + radius + 1;
+	const int y1 = pos.y + SAT_PAD + radius + 1;
+	return sat[y1 * satWidth + x1] - sat[y0 * satWidth + x1] -
+		sat[y1 * satWidth + x0] + sat[y0 * satWidth + x0];
 }
 
-static void MapFloodFill(
-	CArray *fl, const Vec2i size, const int idx, const int elem);
+static int UnionFindRoot(int *parents, int i);
 static void AddCorridor(
 	Map *map, const Vec2i v1, const Vec2i v2, const Vec2i dInit,
 	const unsigned short tile);
 static void LinkDisconnectedAreas(Map *map)
 {
-	// Use flood fill to identify disconnected areas
+	// Use union-find to identify disconnected areas
+	// Each floor tile is joined with the floor tiles above and to its left;
+	// walls are -1
 	CArray fl;
 	CArrayInit(&fl, sizeof(int));
 	const int zero = 0;
 	CArrayResize(&fl, map->iMap.size, &zero);
-	// First copy across the wall tiles (as -1)
-	CA_FOREACH(const unsigned short, tile, map->iMap)
-		if (*tile == MAP_WALL)
+	int *parents = fl.data;
+	const unsigned short *tiles = map->iMap.data;
+	for (int i = 0; i < (int)map->iMap.size; i++)
+	{
+		if (tiles[i] == MAP_WALL)
 		{
-			*(int *)CArrayGet(&fl, _ca_index) = -1;
+			parents[i] = -1;
+			continue;
 		}
-	CA_FOREACH_END()
-	// Then perform flood fill conditionally on the flood layer
+		parents[i] = i;
+		const int x = i % map->Size.x;
+		if (x > 0 && parents[i - 1] >= 0)
+		{
+			parents[i] = UnionFindRoot(parents, i - 1);
+		}
+		if (i >= map->Size.x && parents[i - map->Size.x] >= 0)
+		{
+			const int above = UnionFindRoot(parents, i - map->Size.x);
+			const int root = UnionFindRoot(parents, i);
+			// Keep the earliest tile as the root
+			if (above < root)
+			{
+				parents[root] = above;
+			}
+			else
+			{
+				parents[above] = root;
+			}
+		}
+	}
+	// Then number the areas in the order they first appear
+	// Parents always come before their children, and roots are the first
+	// tile of their area, so this can be done in place in one pass
 	int idx = 1;
-	CA_FOREACH(int, i, fl)
-		if (*i == 0)
+	for (int i = 0; i < (int)fl.size; i++)
+	{
+		if (parents[i] < 0)
 		{
-			MapFloodFill(&fl, map->Size, _ca_index, idx);
-			idx++;
+			continue;
 		}
-	CA_FOREACH_END()
-
+		parents[i] = parents[i] == i ? idx++ : parents[parents[i]];
+	}
 	const int numAreas = idx - 1;
 	// Connect the disconnected areas, first to second, second to third etc.
 	// Select random tile from each area, using index shuffle
@@ -190,48 +233,15 @@ static void LinkDisconnectedAreas(Map *map)
 	CArrayTerminate(&areaStarts);
 }
 
-static void MapFloodFill(
-	CArray *fl, const Vec2i size, const int idx, const int elem)
+static int UnionFindRoot(int *parents, int i)
 {
-	CArray indices;
-	CArrayInit(&indices, sizeof(int));
-	CArrayPushBack(&indices, &idx);
-	const int floodTile = *(int *)CArrayGet(fl, idx);
-	*(int *)CArrayGet(fl, idx) = elem;
-	CA_FOREACH(int, i, indices)
-		const int x = *i % size.x;
-		const int y = *i / size.x;
-		int next;
-		// top
-		next = (y - 1)*size.x + x;
-		if (y > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-		{
-			CArrayPushBack(&indices, &next);
-			*(int *)CArrayGet(fl, next) = elem;
-		}
-		// bottom
-		next = (y + 1)*size.x + x;
-		if (y < size.y - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-		{
-			CArrayPushBack(&indices, &next);
-			*(int *)CArrayGet(fl, next) = elem;
-		}
-		// left
-		next = y*size.x + x - 1;
-		if (x > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-		{
-			CArrayPushBack(&indices, &next);
-			*(int *)CArrayGet(fl, next) = elem;
-		}
-		// right
-		next = y*size.x + x + 1;
-		if (x < size.x - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-		{
-			CArrayPushBack(&indices, &next);
-			*(int *)CArrayGet(fl, next) = elem;
-		}
-	CA_FOREACH_END()
-	CArrayTerminate(&indices);
+	while (parents[i] != i)
+	{
+		// Path halving
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
 }
 
 // Add an S-shaped corridor from one point to another, filling it with a
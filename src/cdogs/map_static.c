@@ -128,7 +128,7 @@ static void AddCharacter(const CharacterPositions *cp)
 
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 		e.u.ActorAdd = aa;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	CA_FOREACH_END()
 }
 static void AddObjective(
@@ -172,7 +172,7 @@ static void AddObjective(
 			aa.FullPos = Vec2i2Net(fullPos);
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 			e.u.ActorAdd = aa;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 		case OBJECTIVE_COLLECT:
@@ -198,7 +198,7 @@ static void AddObjective(
 			aa.FullPos = Vec2i2Net(fullPos);
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 			e.u.ActorAdd = aa;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 		default:
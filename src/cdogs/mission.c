@@ -119,6 +119,13 @@ void MissionInit(Mission *m)
 	CArrayInit(&m->MapObjectDensities, sizeof(MapObjectDensity));
 	CArrayInit(&m->Weapons, sizeof(const GunDescription *));
 }
+// Replace a shallow copy of an array with a copy of its own
+static void CopyPositions(CArray *a)
+{
+	const CArray src = *a;
+	CArrayInit(a, src.elemSize);
+	CArrayCopy(a, &src);
+}
 void MissionCopy(Mission *dst, const Mission *src)
 {
 	if (src == NULL)
@@ -168,10 +175,24 @@ void MissionCopy(Mission *dst, const Mission *src)
 	{
 	case MAPTYPE_STATIC:
 		CArrayCopy(&dst->u.Static.Tiles, &src->u.Static.Tiles);
+		// The position lists are owned by each mission, so copy them too
 		CArrayCopy(&dst->u.Static.Items, &src->u.Static.Items);
+		CA_FOREACH(MapObjectPositions, mop, dst->u.Static.Items)
+			CopyPositions(&mop->Positions);
+		CA_FOREACH_END()
 		CArrayCopy(&dst->u.Static.Characters, &src->u.Static.Characters);
+		CA_FOREACH(CharacterPositions, cp, dst->u.Static.Characters)
+			CopyPositions(&cp->Positions);
+		CA_FOREACH_END()
 		CArrayCopy(&dst->u.Static.Objectives, &src->u.Static.Objectives);
+		CA_FOREACH(ObjectivePositions, op, dst->u.Static.Objectives)
+			CopyPositions(&op->Positions);
+			CopyPositions(&op->Indices);
+		CA_FOREACH_END()
 		CArrayCopy(&dst->u.Static.Keys, &src->u.Static.Keys);
+		CA_FOREACH(KeyPositions, kp, dst->u.Static.Keys)
+			CopyPositions(&kp->Positions);
+		CA_FOREACH_END()
 
 		dst->u.Static.Start = src->u.Static.Start;
 		dst->u.Static.Exit = src->u.Static.Exit;
@@ -200,9 +221,22 @@ void MissionTerminate(Mission *m)
 		break;
 	case MAPTYPE_STATIC:
 		CArrayTerminate(&m->u.Static.Tiles);
+		CA_FOREACH(MapObjectPositions, mop, m->u.Static.Items)
+			CArrayTerminate(&mop->Positions);
+		CA_FOREACH_END()
 		CArrayTerminate(&m->u.Static.Items);
+		CA_FOREACH(CharacterPositions, cp, m->u.Static.Characters)
+			CArrayTerminate(&cp->Positions);
+		CA_FOREACH_END()
 		CArrayTerminate(&m->u.Static.Characters);
+		CA_FOREACH(ObjectivePositions, op, m->u.Static.Objectives)
+			CArrayTerminate(&op->Positions);
+			CArrayTerminate(&op->Indices);
+		CA_FOREACH_END()
 		CArrayTerminate(&m->u.Static.Objectives);
+		CA_FOREACH(KeyPositions, kp, m->u.Static.Keys)
+			CArrayTerminate(&kp->Positions);
+		CA_FOREACH_END()
 		CArrayTerminate(&m->u.Static.Keys);
 		break;
 	case MAPTYPE_CAVE:
@@ -286,7 +320,7 @@ void MissionSetMessageIfComplete(struct MissionOptions *options)
 		{
 			GameEvent msg = GameEventNew(GAME_EVENT_MISSION_COMPLETE);
 			msg.u.MissionComplete = NMakeMissionComplete(options, &gMap);
-			GameEventsEnqueue(&gGameEvents, msg);
+			GameEventsEnqueue(&gGameEvents, &msg);
 		}
 		else if (options->HasBegun && gCampaign.Entry.Mode == GAME_MODE_NORMAL)
 		{
@@ -300,7 +334,7 @@ void MissionSetMessageIfComplete(struct MissionOptions *options)
 						GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
 						e.u.MissionEnd.Delay = GAME_OVER_DELAY;
 						strcpy(e.u.MissionEnd.Msg, "Mission failed");
-						GameEventsEnqueue(&gGameEvents, e);
+						GameEventsEnqueue(&gGameEvents, &e);
 					}
 				}
 			CA_FOREACH_END()
@@ -348,7 +382,7 @@ void UpdateMissionObjective(
 		GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
 		e.u.ObjectiveUpdate.ObjectiveId = idx;
 		e.u.ObjectiveUpdate.Count = count;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
@@ -376,7 +410,7 @@ void MissionBegin(struct MissionOptions *m, const NGameBegin gb)
 			e.u.SetMessage.Message, MusicGetErrorMessage(&gSoundDevice),
 			sizeof e.u.SetMessage.Message - 1);
 		e.u.SetMessage.Ticks = FPS_FRAMELIMIT * 2;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	m->time = gb.MissionTime;
 	m->pickupTime = 0;
@@ -522,6 +522,7 @@ bool MissionStaticTrySetKey(Mission *m, int k, Vec2i pos)
 	FloodFillData data;
 	data.Fill = MissionFillTile;
 	data.IsSame = MissionIsTileSame;
+	data.Size = m->Size;
 	MissionFloodFillData mData;
 	mData.m = m;
 	mData.mask = mask;
@@ -430,7 +430,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			}
 			else
 			{
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 		}
 	}
@@ -281,7 +281,7 @@ static void OnReceive(NetServer *n, ENetEvent event)
 		LOG(LM_NET, LL_TRACE, "recv gameEvent(%d)", (int)gee.Type);
 		GameEvent e = GameEventNew(gee.Type);
 		NetDecode(event.packet, &e.u, gee.Fields);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	else
 	{
@@ -302,7 +302,7 @@ static void OnReceive(NetServer *n, ENetEvent event)
 				if (pData == NULL) continue;
 				GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
 				e.u.PlayerData = PlayerDataMissionReset(pData);
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			// Flush game events to make sure we reset player data
 			HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -393,7 +393,7 @@ static void OnDisconnect(const ENetEvent event)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_PLAYER_REMOVE);
 		e.u.PlayerRemove.UID = (peerId + 1) * MAX_LOCAL_PLAYERS + i;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
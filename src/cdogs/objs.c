@@ -60,6 +60,8 @@ CArray gObjs;
 CArray gMobObjs;
 static unsigned int sObjUIDs = 0;
 static unsigned int sMobObjUIDs = 0;
+// Indices of destroyed mobile objects, reused before growing gMobObjs
+static CArray sMobObjFreeIds;	// of int
 
 
 // Draw functions
@@ -95,7 +97,7 @@ void DamageObject(const NMapObjectDamage mod)
 		e.u.MapObjectRemove.ActorUID = mod.UID;
 		e.u.MapObjectRemove.PlayerUID = mod.PlayerUID;
 		e.u.MapObjectRemove.Flags = mod.Flags;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
@@ -140,7 +142,7 @@ static void AddPickupAtObject(const TObject *o, const PickupType type)
 	e.u.AddPickup.IsRandomSpawned = true;
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = 0;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 static void PlaceWreck(const char *wreckClass, const TTileItem *ti);
@@ -162,7 +164,7 @@ void ObjRemove(const NMapObjectRemove mor)
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = mor.PlayerUID;
 			e.u.Score.Score = OBJECT_SCORE;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 
 		// Weapons that go off when this object is destroyed
@@ -198,7 +200,7 @@ void ObjRemove(const NMapObjectRemove mor)
 		e.u.AddBullet.Flags = 0;
 		e.u.AddBullet.PlayerUID = -1;
 		e.u.AddBullet.ActorUID = -1;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	SoundPlayAt(&gSoundDevice, StrSound("bang"), realPos);
@@ -210,7 +212,7 @@ void ObjRemove(const NMapObjectRemove mor)
 
 	// Update pathfinding cache since this object could have blocked a path
 	// before
-	PathCacheClear(&gPathCache);
+	PathCacheInvalidateTile(&gPathCache, Vec2iToTile(realPos));
 }
 static void PlaceWreck(const char *wreckClass, const TTileItem *ti)
 {
@@ -231,7 +233,7 @@ static void PlaceWreck(const char *wreckClass, const TTileItem *ti)
 	e.u.MapObjectAdd.Pos = Vec2i2Net(Vec2iNew(ti->x, ti->y));
 	e.u.MapObjectAdd.TileItemFlags = MapObjectGetFlags(mo);
 	e.u.MapObjectAdd.Health = mo->Health;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 bool CanHit(const int flags, const int uid, const TTileItem *target)
@@ -307,7 +309,7 @@ void Damage(
 			e.u.MapObjectDamage.ActorUID = uid;
 			e.u.MapObjectDamage.PlayerUID = playerUID;
 			e.u.MapObjectDamage.Flags = flags;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 	default:
@@ -340,7 +342,7 @@ static void DoDamageCharacter(
 		ei.u.ActorImpulse.UID = actor->uid;
 		ei.u.ActorImpulse.Vel = Vec2i2Net(vel);
 		ei.u.ActorImpulse.Pos = Vec2i2Net(actor->Pos);
-		GameEventsEnqueue(&gGameEvents, ei);
+		GameEventsEnqueue(&gGameEvents, &ei);
 	}
 
 	const bool canDamage =
@@ -353,7 +355,7 @@ static void DoDamageCharacter(
 	e.u.ActorHit.Special = special;
 	e.u.ActorHit.Power = canDamage ? power : 0;
 	e.u.ActorHit.Vel = Vec2i2Net(hitVector);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	if (canDamage)
 	{
@@ -375,7 +377,7 @@ static void DoDamageCharacter(
 			{
 				e.u.Score.Score = power;
 			}
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -392,7 +394,7 @@ void UpdateMobileObjects(int ticks)
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_REMOVE_BULLET);
 			e.u.RemoveBullet.UID = obj->UID;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			continue;
 		}
 	CA_FOREACH_END()
@@ -468,7 +470,7 @@ void ObjAdd(const NMapObjectAdd amo)
 		(int)amo.UID, amo.MapObjectClass, amo.Health, amo.Pos.x, amo.Pos.y);
 
 	// Update pathfinding cache since this object could block a path
-	PathCacheClear(&gPathCache);
+	PathCacheInvalidateTile(&gPathCache, Vec2iToTile(Net2Vec2i(amo.Pos)));
 }
 
 void ObjDestroy(TObject *o)
@@ -517,7 +519,7 @@ void UpdateObjects(const int ticks)
 				e.u.AddPickup.TileItemFlags = 0;
 				e.u.AddPickup.Pos =
 					Vec2i2Net(Vec2iNew(obj->tileItem.x, obj->tileItem.y));
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			break;
 		default:
@@ -543,6 +545,8 @@ void MobObjsInit(void)
 {
 	CArrayInit(&gMobObjs, sizeof(TMobileObject));
 	CArrayReserve(&gMobObjs, 1024);
+	CArrayInit(&sMobObjFreeIds, sizeof(int));
+	CArrayReserve(&sMobObjFreeIds, 1024);
 	sMobObjUIDs = 0;
 }
 void MobObjsTerminate(void)
@@ -554,11 +558,32 @@ void MobObjsTerminate(void)
 		}
 	CA_FOREACH_END()
 	CArrayTerminate(&gMobObjs);
+	CArrayTerminate(&sMobObjFreeIds);
 }
 int MobObjsObjsGetNextUID(void)
 {
 	return sMobObjUIDs++;
 }
+int MobObjAlloc(void)
+{
+	int id;
+	if (sMobObjFreeIds.size > 0)
+	{
+		id = *(const int *)CArrayGet(
+			&sMobObjFreeIds, (int)sMobObjFreeIds.size - 1);
+		CArrayDelete(&sMobObjFreeIds, (int)sMobObjFreeIds.size - 1);
+	}
+	else
+	{
+		TMobileObject m;
+		memset(&m, 0, sizeof m);
+		CArrayPushBack(&gMobObjs, &m);
+		id = (int)gMobObjs.size - 1;
+	}
+	TMobileObject *obj = CArrayGet(&gMobObjs, id);
+	memset(obj, 0, sizeof *obj);
+	return id;
+}
 TMobileObject *MobObjGetByUID(const int uid)
 {
 	CA_FOREACH(TMobileObject, o, gMobObjs)
@@ -574,4 +599,6 @@ void MobObjDestroy(TMobileObject *m)
 	CASSERT(m->isInUse, "Destroying not-in-use mobobj");
 	MapRemoveTileItem(&gMap, &m->tileItem);
 	m->isInUse = false;
+	const int id = (int)(m - (TMobileObject *)gMobObjs.data);
+	CArrayPushBack(&sMobObjFreeIds, &id);
 }
@@ -129,5 +129,7 @@ void UpdateMobileObjects(int ticks);
 void MobObjsInit(void);
 void MobObjsTerminate(void);
 int MobObjsObjsGetNextUID(void);
+// Get the index of a cleared, not-in-use mobile object slot
+int MobObjAlloc(void);
 TMobileObject *MobObjGetByUID(const int uid);
 void MobObjDestroy(TMobileObject *m);
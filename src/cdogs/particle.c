@@ -202,7 +202,7 @@ void ParticlesUpdate(CArray *particles, const int ticks)
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_PARTICLE_REMOVE);
 			e.u.ParticleRemoveId = i;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
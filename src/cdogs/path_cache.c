@@ -33,9 +33,12 @@
 #include "ai_utils.h"
 #include "log.h"
 
-#define PATH_CACHE_MAX 128
+#define NO_ENTRY -1
 
-PathCache gPathCache;
+PathCache gPathCache =
+{
+	.freeHead = NO_ENTRY, .lruHead = NO_ENTRY, .lruTail = NO_ENTRY
+};
 
 
 static CachedPath CachedPathCopy(CachedPath *c)
@@ -60,33 +63,207 @@ void CachedPathDestroy(CachedPath *c)
 	}
 }
 
-static bool CachedPathMatches(
-	const CachedPath *c, const Vec2i from, const Vec2i to)
+static PathCacheEntry *GetEntry(const PathCache *pc, const int idx)
 {
-	return Vec2iEqual(c->from, from) && Vec2iEqual(c->to, to);
+	return CArrayGet(&pc->entries, idx);
+}
+static int HashTiles(const Vec2i a, const Vec2i b, const bool ignoreObjects)
+{
+	const unsigned h =
+		(unsigned)a.x * 73856093u ^ (unsigned)a.y * 19349663u ^
+		(unsigned)b.x * 83492791u ^ (unsigned)b.y * 2654435761u ^
+		(unsigned)ignoreObjects;
+	return (int)(h % PATH_CACHE_BUCKETS);
+}
+static int HashFromTo(const PathCacheEntry *e)
+{
+	return HashTiles(e->Path.from, e->Path.to, e->IgnoreObjects);
+}
+static int HashTo(const PathCacheEntry *e)
+{
+	return HashTiles(Vec2iZero(), e->Path.to, e->IgnoreObjects);
+}
+static bool IsInBounds(const Vec2i tile, const Rect2i r)
+{
+	return tile.x >= r.Pos.x && tile.x < r.Pos.x + r.Size.x &&
+		tile.y >= r.Pos.y && tile.y < r.Pos.y + r.Size.y;
+}
+// Expand a tile rect by one tile on every side
+static Rect2i RectGrow(const Rect2i r)
+{
+	Rect2i g;
+	g.Pos = Vec2iMinus(r.Pos, Vec2iNew(1, 1));
+	g.Size = Vec2iAdd(r.Size, Vec2iNew(2, 2));
+	return g;
+}
+static bool EntryMatches(
+	const PathCacheEntry *e, const Vec2i from, const Vec2i to,
+	const bool ignoreObjects)
+{
+	return e->IgnoreObjects == ignoreObjects &&
+		Vec2iEqual(e->Path.from, from) && Vec2iEqual(e->Path.to, to);
 }
 
-
-void PathCacheInit(PathCache *pc, Map *m)
+// LRU list management
+static void LRUUnlink(PathCache *pc, const int idx)
 {
-	CArrayInit(&pc->paths, sizeof(CachedPath));
-	pc->head = 0;
-	pc->map = m;
+	PathCacheEntry *e = GetEntry(pc, idx);
+	if (e->Prev != NO_ENTRY)
+	{
+		GetEntry(pc, e->Prev)->Next = e->Next;
+	}
+	else
+	{
+		pc->lruHead = e->Next;
+	}
+	if (e->Next != NO_ENTRY)
+	{
+		GetEntry(pc, e->Next)->Prev = e->Prev;
+	}
+	else
+	{
+		pc->lruTail = e->Prev;
+	}
+	e->Prev = e->Next = NO_ENTRY;
 }
-void PathCacheTerminate(PathCache *pc)
+static void LRUPushFront(PathCache *pc, const int idx)
 {
-	PathCacheClear(pc);
-	CArrayTerminate(&pc->paths);
+	PathCacheEntry *e = GetEntry(pc, idx);
+	e->Prev = NO_ENTRY;
+	e->Next = pc->lruHead;
+	if (pc->lruHead != NO_ENTRY)
+	{
+		GetEntry(pc, pc->lruHead)->Prev = idx;
+	}
+	pc->lruHead = idx;
+	if (pc->lruTail == NO_ENTRY)
+	{
+		pc->lruTail = idx;
+	}
 }
 
-void PathCacheClear(PathCache *pc)
+static void BucketUnlink(
+	PathCache *pc, int *bucket, const int idx, const bool isTo)
+{
+	for (int *link = bucket; *link != NO_ENTRY;)
+	{
+		PathCacheEntry *e = GetEntry(pc, *link);
+		if (*link == idx)
+		{
+			*link = isTo ? e->ToHashNext : e->HashNext;
+			return;
+		}
+		link = isTo ? &e->ToHashNext : &e->HashNext;
+	}
+	CASSERT(false, "path cache entry not in bucket");
+}
+static void EntryRemove(PathCache *pc, const int idx)
 {
-	CA_FOREACH(CachedPath, c, pc->paths)
-		CachedPathDestroy(c);
-	CA_FOREACH_END()
-	CArrayClear(&pc->paths);
-	pc->head = 0;
+	PathCacheEntry *e = GetEntry(pc, idx);
+	CASSERT(e->IsUsed, "removing unused path cache entry");
+	BucketUnlink(pc, &pc->buckets[HashFromTo(e)], idx, false);
+	BucketUnlink(pc, &pc->toBuckets[HashTo(e)], idx, true);
+	LRUUnlink(pc, idx);
+	pc->size -= e->Size;
+	CachedPathDestroy(&e->Path);
+	e->IsUsed = false;
+	e->HashNext = pc->freeHead;
+	pc->freeHead = idx;
+}
+static void EvictToBudget(PathCache *pc)
+{
+	while (pc->size > pc->budget && pc->lruTail != NO_ENTRY)
+	{
+		EntryRemove(pc, pc->lruTail);
+	}
+}
+static void EntryAdd(
+	PathCache *pc, const CachedPath *cp, const bool ignoreObjects)
+{
+	int idx = pc->freeHead;
+	if (idx != NO_ENTRY)
+	{
+		pc->freeHead = GetEntry(pc, idx)->HashNext;
+	}
+	else
+	{
+		PathCacheEntry blank;
+		memset(&blank, 0, sizeof blank);
+		CArrayPushBack(&pc->entries, &blank);
+		idx = (int)pc->entries.size - 1;
+	}
+	PathCacheEntry *e = GetEntry(pc, idx);
+	memset(e, 0, sizeof *e);
+	e->Path = *cp;
+	e->IgnoreObjects = ignoreObjects;
+	e->IsUsed = true;
+	const size_t count = ASPathGetCount(cp->Path);
+	e->Size = sizeof *e + count * sizeof(Vec2i);
+	e->Bounds.Pos = cp->from;
+	Vec2i maxTile = cp->from;
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vec2i *v = ASPathGetNode(cp->Path, i);
+		e->Bounds.Pos = Vec2iMin(e->Bounds.Pos, *v);
+		maxTile = Vec2iMax(maxTile, *v);
+	}
+	e->Bounds.Size = Vec2iAdd(
+		Vec2iMinus(maxTile, e->Bounds.Pos), Vec2iNew(1, 1));
+	int *bucket = &pc->buckets[HashFromTo(e)];
+	e->HashNext = *bucket;
+	*bucket = idx;
+	bucket = &pc->toBuckets[HashTo(e)];
+	e->ToHashNext = *bucket;
+	*bucket = idx;
+	LRUPushFront(pc, idx);
+	pc->size += e->Size;
+	EvictToBudget(pc);
 }
+static int EntryFind(
+	const PathCache *pc, const Vec2i from, const Vec2i to,
+	const bool ignoreObjects)
+{
+	for (int idx = pc->buckets[HashTiles(from, to, ignoreObjects)];
+		idx != NO_ENTRY;
+		idx = GetEntry(pc, idx)->HashNext)
+	{
+		if (EntryMatches(GetEntry(pc, idx), from, to, ignoreObjects))
+		{
+			return idx;
+		}
+	}
+	return NO_ENTRY;
+}
+// Find a cached path to the same goal that goes through the start tile,
+// so that we can reuse the rest of it
+static ASPath FindSuffix(
+	const PathCache *pc, const Vec2i from, const Vec2i to,
+	const bool ignoreObjects)
+{
+	for (int idx = pc->toBuckets[HashTiles(Vec2iZero(), to, ignoreObjects)];
+		idx != NO_ENTRY;
+		idx = GetEntry(pc, idx)->ToHashNext)
+	{
+		const PathCacheEntry *e = GetEntry(pc, idx);
+		if (e->IgnoreObjects != ignoreObjects ||
+			!Vec2iEqual(e->Path.to, to) ||
+			!IsInBounds(from, e->Bounds))
+		{
+			continue;
+		}
+		const size_t count = ASPathGetCount(e->Path.Path);
+		for (size_t i = 1; i + 1 < count; i++)
+		{
+			const Vec2i *v = ASPathGetNode(e->Path.Path, i);
+			if (Vec2iEqual(*v, from))
+			{
+				return ASPathCopyFrom(e->Path.Path, i);
+			}
+		}
+	}
+	return NULL;
+}
+
 
 typedef struct
 {
@@ -96,34 +273,149 @@ typedef struct
 static void AddTileNeighbors(
 	ASNeighborList neighbors, void *node, void *context);
 static float AStarHeuristic(void *fromNode, void *toNode, void *context);
+static size_t TileIndex(void *node, void *context);
 static ASPathNodeSource cPathNodeSource =
 {
-	sizeof(Vec2i), AddTileNeighbors, AStarHeuristic, NULL, NULL
+	sizeof(Vec2i), AddTileNeighbors, AStarHeuristic, NULL, NULL,
+	TileIndex
 };
-CachedPath PathCacheCreate(
-	PathCache *pc, Vec2i from, Vec2i to,
-	const bool ignoreObjects, const bool cache)
+
+
+void PathCacheInit(PathCache *pc, Map *m)
 {
-	// Search through existing cache for path
-	CA_FOREACH(CachedPath, c, pc->paths)
-		if (CachedPathMatches(c, from, to))
+	CArrayInit(&pc->entries, sizeof(PathCacheEntry));
+	for (int i = 0; i < PATH_CACHE_BUCKETS; i++)
+	{
+		pc->buckets[i] = NO_ENTRY;
+		pc->toBuckets[i] = NO_ENTRY;
+	}
+	pc->freeHead = NO_ENTRY;
+	pc->lruHead = pc->lruTail = NO_ENTRY;
+	pc->size = 0;
+	pc->budget = PATH_CACHE_BUDGET;
+	pc->map = m;
+	pc->search = ASPathContextCreate(
+		&cPathNodeSource, (size_t)(m->Size.x * m->Size.y));
+	PathChunksInit(&pc->Chunks, m);
+	FlowFieldsInit(&pc->FlowFields, m);
+}
+void PathCacheTerminate(PathCache *pc)
+{
+	// Nothing to do if the cache was never initialised, e.g. the first map
+	// load terminates the previous (nonexistent) map
+	if (pc->entries.elemSize == 0)
+	{
+		return;
+	}
+	PathCacheClear(pc);
+	CArrayTerminate(&pc->entries);
+	ASPathContextDestroy(pc->search);
+	PathChunksTerminate(&pc->Chunks);
+	FlowFieldsTerminate(&pc->FlowFields);
+	memset(pc, 0, sizeof *pc);
+	pc->freeHead = pc->lruHead = pc->lruTail = NO_ENTRY;
+}
+void PathCacheSetBudget(PathCache *pc, const size_t budget)
+{
+	pc->budget = budget;
+	EvictToBudget(pc);
+}
+
+void PathCacheBuild(PathCache *pc)
+{
+	PathChunksUpdate(&pc->Chunks);
+}
+
+void PathCacheClear(PathCache *pc)
+{
+	if (pc->entries.elemSize == 0)
+	{
+		return;
+	}
+	while (pc->lruHead != NO_ENTRY)
+	{
+		EntryRemove(pc, pc->lruHead);
+	}
+}
+
+void PathCacheInvalidateTile(PathCache *pc, const Vec2i tile)
+{
+	int removed = 0;
+	for (int idx = pc->lruHead; idx != NO_ENTRY;)
+	{
+		const PathCacheEntry *e = GetEntry(pc, idx);
+		const int next = e->Next;
+		// Paths that failed may now be possible
+		bool remove = e->Path.Path == NULL;
+		// Diagonal steps need both their corner tiles to be clear, so a path
+		// is also affected if it only passes next to the tile
+		if (!remove && IsInBounds(tile, RectGrow(e->Bounds)))
+		{
+			const size_t count = ASPathGetCount(e->Path.Path);
+			for (size_t i = 0; i < count; i++)
+			{
+				const Vec2i *v = ASPathGetNode(e->Path.Path, i);
+				if (abs(v->x - tile.x) <= 1 && abs(v->y - tile.y) <= 1)
+				{
+					remove = true;
+					break;
+				}
+			}
+		}
+		if (remove)
 		{
-			LOG(LM_PATH, LL_TRACE, "cached path (%d, %d) to (%d, %d)...",
-				from.x, from.y, to.x, to.y);
-			return CachedPathCopy(c);
+			EntryRemove(pc, idx);
+			removed++;
 		}
-	CA_FOREACH_END()
+		idx = next;
+	}
+	LOG(LM_PATH, LL_TRACE, "tile (%d, %d) changed, removed %d cached paths",
+		tile.x, tile.y, removed);
+	PathChunksInvalidateTile(&pc->Chunks, tile);
+	FlowFieldsInvalidate(&pc->FlowFields);
+}
+void PathCacheInvalidateKeys(PathCache *pc, const int keyFlags)
+{
+	// New keys can open up shortcuts anywhere; start again
+	PathCacheClear(pc);
+	PathChunksInvalidateKeys(&pc->Chunks, keyFlags);
+	FlowFieldsInvalidate(&pc->FlowFields);
+}
 
-	LOG(LM_PATH, LL_TRACE, "find path (%d, %d) to (%d, %d)...",
-		from.x, from.y, to.x, to.y);
-	const clock_t start = clock();
+CachedPath PathCacheCreate(
+	PathCache *pc, Vec2i from, Vec2i to,
+	const bool ignoreObjects, const bool cache)
+{
+	// Search the cache for the path
+	const int idx = EntryFind(pc, from, to, ignoreObjects);
+	if (idx != NO_ENTRY)
+	{
+		LOG(LM_PATH, LL_TRACE, "cached path (%d, %d) to (%d, %d)...",
+			from.x, from.y, to.x, to.y);
+		LRUUnlink(pc, idx);
+		LRUPushFront(pc, idx);
+		return CachedPathCopy(&GetEntry(pc, idx)->Path);
+	}
 
-	// Cached path not found; find the path now
 	CachedPath cp;
-	AStarContext ac;
-	ac.Map = pc->map;
-	ac.IsTileOk = ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects;
-	cp.Path = ASPathCreate(&cPathNodeSource, &ac, &from, &to);
+	cp.Path = FindSuffix(pc, from, to, ignoreObjects);
+	const clock_t start = clock();
+	if (cp.Path != NULL)
+	{
+		LOG(LM_PATH, LL_TRACE, "reuse cached path (%d, %d) to (%d, %d)...",
+			from.x, from.y, to.x, to.y);
+	}
+	else
+	{
+		// Cached path not found; find the path now
+		LOG(LM_PATH, LL_TRACE, "find path (%d, %d) to (%d, %d)...",
+			from.x, from.y, to.x, to.y);
+		AStarContext ac;
+		ac.Map = pc->map;
+		ac.IsTileOk =
+			ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects;
+		cp.Path = ASPathContextCreatePath(pc->search, &ac, &from, &to);
+	}
 	CMALLOC(cp.refs, sizeof *cp.refs);
 	(*cp.refs) = 1;
 	cp.from = from;
@@ -132,25 +424,8 @@ CachedPath PathCacheCreate(
 	if (cache)
 	{
 		(*cp.refs)++;
-		// Add to the cache if we are under the max size
-		if ((int)pc->paths.size < PATH_CACHE_MAX)
-		{
-			CArrayPushBack(&pc->paths, &cp);
-		}
-		else
-		{
-			// Replace the oldest cached path with this one
-			CachedPath *oldest = CArrayGet(&pc->paths, pc->head);
-			CachedPathDestroy(oldest);
-			memcpy(oldest, &cp, sizeof cp);
-			// Move the head
-			pc->head++;
-			if (pc->head == pc->paths.size)
-			{
-				pc->head = 0;
-			}
-		}
-		LOG(LM_PATH, LL_TRACE, "Cached %d paths", (int)pc->paths.size);
+		EntryAdd(pc, &cp, ignoreObjects);
+		LOG(LM_PATH, LL_TRACE, "Cached %d bytes of paths", (int)pc->size);
 	}
 	const clock_t diff = clock() - start;
 	const int ms = diff * 1000 / CLOCKS_PER_SEC;
@@ -222,3 +497,9 @@ static float AStarHeuristic(void *fromNode, void *toNode, void *context)
 	return (float)sqrt(DistanceSquared(
 		Vec2iCenterOfTile(*v1), Vec2iCenterOfTile(*v2)));
 }
+static size_t TileIndex(void *node, void *context)
+{
+	const Vec2i *v = node;
+	const AStarContext *c = context;
+	return (size_t)(v->y * c->Map->Size.x + v->x);
+}
@@ -29,7 +29,9 @@
 
 #include "AStar.h"
 #include "c_array.h"
+#include "flow_field.h"
 #include "map.h"
+#include "path_chunks.h"
 #include "vector.h"
 
 // Ref-counted path reference
@@ -42,15 +44,50 @@ typedef struct
 	Vec2i to;
 } CachedPath;
 
+// Default memory budget for cached paths, in bytes
+#define PATH_CACHE_BUDGET (256 * 1024)
+#define PATH_CACHE_BUCKETS 256
+
+typedef struct
+{
+	CachedPath Path;
+	bool IgnoreObjects;
+	// Approximate memory used by the path, in bytes
+	size_t Size;
+	// Bounding box of the path's tiles, for quick invalidation checks
+	Rect2i Bounds;
+	// Next entries in the same hash buckets, by (from, to) and by (to)
+	// For unused entries, HashNext is the next free entry
+	int HashNext;
+	int ToHashNext;
+	// Neighbours in the LRU list, most recently used first
+	int Prev;
+	int Next;
+	bool IsUsed;
+} PathCacheEntry;
+
 typedef struct
 {
-	CArray paths;	// of CachedPath
-	size_t head;
+	CArray entries;	// of PathCacheEntry
+	int buckets[PATH_CACHE_BUCKETS];
+	int toBuckets[PATH_CACHE_BUCKETS];
+	int freeHead;
+	int lruHead;
+	int lruTail;
+	size_t size;
+	size_t budget;
 	Map *map;
+	// Reused for each path search
+	ASPathContext search;
+	PathChunks Chunks;
+	FlowFields FlowFields;
 } PathCache;
 
 // Cache of A* paths so similar paths don't need to be recalculated
 // Mainly to work around AI repeating the same pathfinds rapidly
+// Paths are looked up by (from, to, ignoreObjects); a path that goes
+// through the start tile to the same goal is also reused.
+// The least recently used paths are evicted once over the memory budget.
 // Note: lifetime managed by Map
 extern PathCache gPathCache;
 
@@ -58,12 +95,23 @@ void CachedPathDestroy(CachedPath *c);
 
 void PathCacheInit(PathCache *pc, Map *m);
 void PathCacheTerminate(PathCache *pc);
+void PathCacheSetBudget(PathCache *pc, const size_t budget);
+// Build the long-range pathfinding data for a loaded map, so the first
+// long-range search doesn't have to; tiles that change later are rebuilt
+// when next needed
+void PathCacheBuild(PathCache *pc);
 
 // Clear all entries in cache
-// This is done when the underlying map changes, changing paths
+// This is done when the underlying map changes a lot, changing paths
 // e.g. keys
 void PathCacheClear(PathCache *pc);
+// Update pathfinding data when the walkability of a tile changes;
+// only the paths that go through or cut the corner of the tile, or failed
+// to find a path, are removed
+void PathCacheInvalidateTile(PathCache *pc, const Vec2i tile);
+// Update pathfinding data when new keys are picked up
+void PathCacheInvalidateKeys(PathCache *pc, const int keyFlags);
 
 CachedPath PathCacheCreate(
 	PathCache *pc, Vec2i from, Vec2i to,
-	const bool ignoreObjects, const bool cache);
\ No newline at end of file
+	const bool ignoreObjects, const bool cache);
@@ -0,0 +1,601 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "path_chunks.h"
+
+#include <math.h>
+#include <time.h>
+
+#include "AStar.h"
+#include "ai_utils.h"
+#include "log.h"
+
+#define CHUNK_TILES (PATH_CHUNK_SIZE * PATH_CHUNK_SIZE)
+// Maximum number of items in the Dijkstra heap; each tile can be pushed
+// once per neighbour
+#define HEAP_MAX (CHUNK_TILES * 8 + 1)
+
+static const Vec2i sBorderDirs[] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+
+static bool IsChunkIn(const PathChunks *pc, const Vec2i chunk)
+{
+	return chunk.x >= 0 && chunk.x < pc->Size.x &&
+		chunk.y >= 0 && chunk.y < pc->Size.y;
+}
+static int ChunkIndex(const PathChunks *pc, const Vec2i chunk)
+{
+	return chunk.y * pc->Size.x + chunk.x;
+}
+static PathChunk *GetChunk(const PathChunks *pc, const Vec2i chunk)
+{
+	return CArrayGet(&pc->Chunks, ChunkIndex(pc, chunk));
+}
+static Vec2i TileToChunk(const Vec2i tile)
+{
+	return Vec2iNew(tile.x / PATH_CHUNK_SIZE, tile.y / PATH_CHUNK_SIZE);
+}
+static Rect2i ChunkBounds(const PathChunks *pc, const Vec2i chunk)
+{
+	Rect2i r;
+	r.Pos = Vec2iScale(chunk, PATH_CHUNK_SIZE);
+	r.Size = Vec2iMin(
+		Vec2iNew(PATH_CHUNK_SIZE, PATH_CHUNK_SIZE),
+		Vec2iMinus(pc->map->Size, r.Pos));
+	return r;
+}
+static int LocalIndex(const Vec2i tile)
+{
+	return (tile.y % PATH_CHUNK_SIZE) * PATH_CHUNK_SIZE +
+		tile.x % PATH_CHUNK_SIZE;
+}
+
+
+void PathChunksInit(PathChunks *pc, Map *m)
+{
+	memset(pc, 0, sizeof *pc);
+	pc->map = m;
+	pc->Size = Vec2iNew(
+		(m->Size.x + PATH_CHUNK_SIZE - 1) / PATH_CHUNK_SIZE,
+		(m->Size.y + PATH_CHUNK_SIZE - 1) / PATH_CHUNK_SIZE);
+	CArrayInit(&pc->Chunks, sizeof(PathChunk));
+	for (int i = 0; i < pc->Size.x * pc->Size.y; i++)
+	{
+		PathChunk c;
+		memset(&c, 0, sizeof c);
+		CArrayInit(&c.Nodes, sizeof(PathChunkNode));
+		c.IsDirty = true;
+		CArrayPushBack(&pc->Chunks, &c);
+	}
+	// The map hasn't been loaded yet; it is built by PathChunksUpdate once
+	// it has
+	pc->HasDirty = true;
+}
+void PathChunksTerminate(PathChunks *pc)
+{
+	CA_FOREACH(PathChunk, c, pc->Chunks)
+		for (int i = 0; i < (int)c->Nodes.size; i++)
+		{
+			PathChunkNode *n = CArrayGet(&c->Nodes, i);
+			CArrayTerminate(&n->Edges);
+		}
+		CArrayTerminate(&c->Nodes);
+	CA_FOREACH_END()
+	CArrayTerminate(&pc->Chunks);
+	ASPathContextDestroy(pc->Search);
+	memset(pc, 0, sizeof *pc);
+}
+
+void PathChunksInvalidateTile(PathChunks *pc, const Vec2i tile)
+{
+	if (pc->Chunks.size == 0 || !MapIsTileIn(pc->map, tile))
+	{
+		return;
+	}
+	GetChunk(pc, TileToChunk(tile))->IsDirty = true;
+	pc->HasDirty = true;
+}
+void PathChunksInvalidateKeys(PathChunks *pc, const int keyFlags)
+{
+	CA_FOREACH(PathChunk, c, pc->Chunks)
+		if (c->KeyMask & keyFlags)
+		{
+			c->IsDirty = true;
+			pc->HasDirty = true;
+		}
+	CA_FOREACH_END()
+}
+
+
+static void GetWalkable(
+	const PathChunks *pc, const Vec2i chunk, bool *walkable)
+{
+	const Rect2i b = ChunkBounds(pc, chunk);
+	memset(walkable, 0, CHUNK_TILES * sizeof *walkable);
+	Vec2i v;
+	for (v.y = b.Pos.y; v.y < b.Pos.y + b.Size.y; v.y++)
+	{
+		for (v.x = b.Pos.x; v.x < b.Pos.x + b.Size.x; v.x++)
+		{
+			walkable[LocalIndex(v)] = IsTileWalkable(pc->map, v);
+		}
+	}
+}
+
+typedef struct
+{
+	float Cost;
+	int Index;
+} HeapItem;
+static void HeapPush(HeapItem *heap, int *count, const HeapItem item)
+{
+	int i = (*count)++;
+	while (i > 0)
+	{
+		const int parent = (i - 1) / 2;
+		if (heap[parent].Cost <= item.Cost)
+		{
+			break;
+		}
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i] = item;
+}
+static HeapItem HeapPop(HeapItem *heap, int *count)
+{
+	const HeapItem top = heap[0];
+	const HeapItem last = heap[--(*count)];
+	int i = 0;
+	for (;;)
+	{
+		int child = 2 * i + 1;
+		if (child >= *count)
+		{
+			break;
+		}
+		if (child + 1 < *count && heap[child + 1].Cost < heap[child].Cost)
+		{
+			child++;
+		}
+		if (last.Cost <= heap[child].Cost)
+		{
+			break;
+		}
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = last;
+	return top;
+}
+
+// Find the costs from a tile to every other tile in the same chunk,
+// without leaving the chunk. Unreachable tiles have negative cost.
+// Movement rules and costs are the same as for the tile A*.
+static void ChunkDijkstra(
+	const PathChunks *pc, const Vec2i chunk, const bool *walkable,
+	const Vec2i start, float *costs)
+{
+	const Rect2i b = ChunkBounds(pc, chunk);
+	for (int i = 0; i < CHUNK_TILES; i++)
+	{
+		costs[i] = -1;
+	}
+	HeapItem heap[HEAP_MAX];
+	int count = 0;
+	const HeapItem first = { 0, LocalIndex(start) };
+	HeapPush(heap, &count, first);
+	costs[first.Index] = 0;
+	while (count > 0)
+	{
+		const HeapItem h = HeapPop(heap, &count);
+		if (h.Cost > costs[h.Index])
+		{
+			// Stale entry; we've already found a cheaper way here
+			continue;
+		}
+		const int x = h.Index % PATH_CHUNK_SIZE;
+		const int y = h.Index / PATH_CHUNK_SIZE;
+		if (!walkable[h.Index])
+		{
+			continue;
+		}
+		for (int dy = -1; dy <= 1; dy++)
+		{
+			const int ny = y + dy;
+			if (ny < 0 || ny >= b.Size.y)
+			{
+				continue;
+			}
+			for (int dx = -1; dx <= 1; dx++)
+			{
+				const int nx = x + dx;
+				if ((dx == 0 && dy == 0) || nx < 0 || nx >= b.Size.x)
+				{
+					continue;
+				}
+				const int n = ny * PATH_CHUNK_SIZE + nx;
+				// if we're moving diagonally,
+				// need to check the axis-aligned neighbours are also clear
+				if (!walkable[n] ||
+					!walkable[ny * PATH_CHUNK_SIZE + x] ||
+					!walkable[y * PATH_CHUNK_SIZE + nx])
+				{
+					continue;
+				}
+				float cost;
+				if (dx != 0 && dy != 0)
+				{
+					cost = TILE_WIDTH * 1.1f;
+				}
+				else if (dx != 0)
+				{
+					cost = TILE_WIDTH;
+				}
+				else
+				{
+					cost = TILE_HEIGHT;
+				}
+				cost += h.Cost;
+				if (costs[n] < 0 || cost < costs[n])
+				{
+					costs[n] = cost;
+					const HeapItem next = { cost, n };
+					HeapPush(heap, &count, next);
+				}
+			}
+		}
+	}
+}
+
+// Recalculate the costs between all the entrances of a chunk
+static void ChunkBuildEdges(PathChunks *pc, const Vec2i chunk)
+{
+	PathChunk *c = GetChunk(pc, chunk);
+	bool walkable[CHUNK_TILES];
+	GetWalkable(pc, chunk, walkable);
+
+	// Find which keys the doors here need, so we know when to rebuild
+	c->KeyMask = 0;
+	const Rect2i b = ChunkBounds(pc, chunk);
+	Vec2i v;
+	for (v.y = b.Pos.y; v.y < b.Pos.y + b.Size.y; v.y++)
+	{
+		for (v.x = b.Pos.x; v.x < b.Pos.x + b.Size.x; v.x++)
+		{
+			if (MapGetTile(pc->map, v)->flags & MAPTILE_OFFSET_PIC)
+			{
+				c->KeyMask |= MapGetDoorKeycardFlag(pc->map, v);
+			}
+		}
+	}
+
+	float costs[CHUNK_TILES];
+	CA_FOREACH(PathChunkNode, n, c->Nodes)
+		CArrayClear(&n->Edges);
+		ChunkDijkstra(pc, chunk, walkable, n->Tile, costs);
+		for (int i = 0; i < (int)c->Nodes.size; i++)
+		{
+			const PathChunkNode *other = CArrayGet(&c->Nodes, i);
+			const float cost = costs[LocalIndex(other->Tile)];
+			if (i == _ca_index || cost < 0)
+			{
+				continue;
+			}
+			const PathChunkEdge e = { i, cost };
+			CArrayPushBack(&n->Edges, &e);
+		}
+	CA_FOREACH_END()
+}
+
+static void RemoveBorderNodes(PathChunk *c, const Vec2i dir)
+{
+	for (int i = (int)c->Nodes.size - 1; i >= 0; i--)
+	{
+		PathChunkNode *n = CArrayGet(&c->Nodes, i);
+		if (Vec2iEqual(Vec2iMinus(n->Partner, n->Tile), dir))
+		{
+			CArrayTerminate(&n->Edges);
+			CArrayDelete(&c->Nodes, i);
+		}
+	}
+}
+static void AddNode(PathChunk *c, const Vec2i tile, const Vec2i partner)
+{
+	PathChunkNode n;
+	n.Tile = tile;
+	n.Partner = partner;
+	CArrayInit(&n.Edges, sizeof(PathChunkEdge));
+	CArrayPushBack(&c->Nodes, &n);
+}
+// Place entrances along the border between a chunk and its neighbour;
+// one entrance for each run of tiles that can be walked across
+static void BuildBorder(PathChunks *pc, const Vec2i chunk, const Vec2i dir)
+{
+	const Vec2i otherChunk = Vec2iAdd(chunk, dir);
+	if (!IsChunkIn(pc, otherChunk))
+	{
+		return;
+	}
+	PathChunk *c = GetChunk(pc, chunk);
+	PathChunk *other = GetChunk(pc, otherChunk);
+	RemoveBorderNodes(c, dir);
+	RemoveBorderNodes(other, Vec2iScale(dir, -1));
+
+	// Walk along the tiles on our side of the border
+	const Rect2i b = ChunkBounds(pc, chunk);
+	Vec2i start = b.Pos;
+	Vec2i step;
+	int length;
+	if (dir.x != 0)
+	{
+		if (dir.x > 0) start.x += b.Size.x - 1;
+		step = Vec2iNew(0, 1);
+		length = b.Size.y;
+	}
+	else
+	{
+		if (dir.y > 0) start.y += b.Size.y - 1;
+		step = Vec2iNew(1, 0);
+		length = b.Size.x;
+	}
+	int runStart = -1;
+	for (int i = 0; i <= length; i++)
+	{
+		bool isOpen = false;
+		if (i < length)
+		{
+			const Vec2i t = Vec2iAdd(start, Vec2iScale(step, i));
+			isOpen =
+				IsTileWalkable(pc->map, t) &&
+				IsTileWalkable(pc->map, Vec2iAdd(t, dir));
+		}
+		if (isOpen && runStart < 0)
+		{
+			runStart = i;
+		}
+		else if (!isOpen && runStart >= 0)
+		{
+			// Place the entrance in the middle of the run
+			const Vec2i t =
+				Vec2iAdd(start, Vec2iScale(step, (runStart + i - 1) / 2));
+			AddNode(c, t, Vec2iAdd(t, dir));
+			AddNode(other, Vec2iAdd(t, dir), t);
+			runStart = -1;
+		}
+	}
+}
+
+static void ChunkRebuild(PathChunks *pc, const Vec2i chunk)
+{
+	for (int i = 0; i < (int)(sizeof sBorderDirs / sizeof sBorderDirs[0]); i++)
+	{
+		BuildBorder(pc, chunk, sBorderDirs[i]);
+	}
+	// The border entrances of the neighbours have changed too
+	ChunkBuildEdges(pc, chunk);
+	for (int i = 0; i < (int)(sizeof sBorderDirs / sizeof sBorderDirs[0]); i++)
+	{
+		const Vec2i other = Vec2iAdd(chunk, sBorderDirs[i]);
+		if (IsChunkIn(pc, other))
+		{
+			ChunkBuildEdges(pc, other);
+		}
+	}
+	GetChunk(pc, chunk)->IsDirty = false;
+}
+
+void PathChunksUpdate(PathChunks *pc)
+{
+	if (!pc->HasDirty)
+	{
+		return;
+	}
+	const clock_t start = clock();
+	int rebuilt = 0;
+	Vec2i v;
+	for (v.y = 0; v.y < pc->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < pc->Size.x; v.x++)
+		{
+			if (GetChunk(pc, v)->IsDirty)
+			{
+				ChunkRebuild(pc, v);
+				rebuilt++;
+			}
+		}
+	}
+	pc->HasDirty = false;
+	const int ms = (int)((clock() - start) * 1000 / CLOCKS_PER_SEC);
+	LOG(LM_PATH, LL_DEBUG, "Rebuilt %d path chunks in %dms", rebuilt, ms);
+}
+
+
+// Nodes of the abstract graph
+// The start and goal are special nodes, which aren't stored in chunks
+typedef struct
+{
+	int Chunk;	// -1 for the start and goal
+	int Index;
+} NodeId;
+#define NODE_START 0
+#define NODE_GOAL 1
+typedef struct
+{
+	PathChunks *pc;
+	Vec2i From;
+	Vec2i To;
+	int FromChunk;
+	int ToChunk;
+	float FromCosts[CHUNK_TILES];
+	float ToCosts[CHUNK_TILES];
+} SearchContext;
+
+static Vec2i NodeTile(const SearchContext *sc, const NodeId *n)
+{
+	if (n->Chunk < 0)
+	{
+		return n->Index == NODE_START ? sc->From : sc->To;
+	}
+	const PathChunk *c = CArrayGet(&sc->pc->Chunks, n->Chunk);
+	const PathChunkNode *cn = CArrayGet(&c->Nodes, n->Index);
+	return cn->Tile;
+}
+static bool FindNode(const PathChunks *pc, const Vec2i tile, NodeId *id)
+{
+	id->Chunk = ChunkIndex(pc, TileToChunk(tile));
+	const PathChunk *c = CArrayGet(&pc->Chunks, id->Chunk);
+	CA_FOREACH(const PathChunkNode, n, c->Nodes)
+		if (Vec2iEqual(n->Tile, tile))
+		{
+			id->Index = _ca_index;
+			return true;
+		}
+	CA_FOREACH_END()
+	return false;
+}
+static void AddNodeNeighbors(
+	ASNeighborList neighbors, void *node, void *context)
+{
+	const NodeId *id = node;
+	const SearchContext *sc = context;
+	if (id->Chunk < 0)
+	{
+		// The goal has no neighbours since the search ends there
+		if (id->Index != NODE_START)
+		{
+			return;
+		}
+		// Connect the start to the entrances of its chunk
+		const PathChunk *c = CArrayGet(&sc->pc->Chunks, sc->FromChunk);
+		CA_FOREACH(const PathChunkNode, n, c->Nodes)
+			const float cost = sc->FromCosts[LocalIndex(n->Tile)];
+			if (cost >= 0)
+			{
+				NodeId next = { sc->FromChunk, _ca_index };
+				ASNeighborListAdd(neighbors, &next, cost);
+			}
+		CA_FOREACH_END()
+		return;
+	}
+	const PathChunk *c = CArrayGet(&sc->pc->Chunks, id->Chunk);
+	const PathChunkNode *n = CArrayGet(&c->Nodes, id->Index);
+	CA_FOREACH(const PathChunkEdge, e, n->Edges)
+		NodeId next = { id->Chunk, e->To };
+		ASNeighborListAdd(neighbors, &next, e->Cost);
+	CA_FOREACH_END()
+	// Cross the border
+	NodeId partner;
+	if (FindNode(sc->pc, n->Partner, &partner))
+	{
+		const float cost =
+			n->Partner.x != n->Tile.x ? TILE_WIDTH : TILE_HEIGHT;
+		ASNeighborListAdd(neighbors, &partner, cost);
+	}
+	if (id->Chunk == sc->ToChunk)
+	{
+		const float cost = sc->ToCosts[LocalIndex(n->Tile)];
+		if (cost >= 0)
+		{
+			NodeId goal = { -1, NODE_GOAL };
+			ASNeighborListAdd(neighbors, &goal, cost);
+		}
+	}
+}
+static float NodeHeuristic(void *fromNode, void *toNode, void *context)
+{
+	// Simple Euclidean
+	const SearchContext *sc = context;
+	const Vec2i v1 = NodeTile(sc, fromNode);
+	const Vec2i v2 = NodeTile(sc, toNode);
+	return (float)sqrt(DistanceSquared(
+		Vec2iCenterOfTile(v1), Vec2iCenterOfTile(v2)));
+}
+static ASPathNodeSource cNodeSource =
+{
+	sizeof(NodeId), AddNodeNeighbors, NodeHeuristic, NULL, NULL, NULL
+};
+
+bool PathChunksFindWaypoints(
+	PathChunks *pc, const Vec2i from, const Vec2i to, CArray *waypoints)
+{
+	CArrayClear(waypoints);
+	if (pc->Chunks.size == 0 ||
+		!MapIsTileIn(pc->map, from) || !MapIsTileIn(pc->map, to))
+	{
+		return false;
+	}
+	const Vec2i fromChunk = TileToChunk(from);
+	const Vec2i toChunk = TileToChunk(to);
+	// Only worth it if the path crosses at least one whole chunk
+	if (CHEBYSHEV_DISTANCE(fromChunk.x, fromChunk.y, toChunk.x, toChunk.y) < 2)
+	{
+		return false;
+	}
+	PathChunksUpdate(pc);
+
+	SearchContext sc;
+	sc.pc = pc;
+	sc.From = from;
+	sc.To = to;
+	sc.FromChunk = ChunkIndex(pc, fromChunk);
+	sc.ToChunk = ChunkIndex(pc, toChunk);
+	bool walkable[CHUNK_TILES];
+	GetWalkable(pc, fromChunk, walkable);
+	ChunkDijkstra(pc, fromChunk, walkable, from, sc.FromCosts);
+	GetWalkable(pc, toChunk, walkable);
+	ChunkDijkstra(pc, toChunk, walkable, to, sc.ToCosts);
+
+	NodeId start = { -1, NODE_START };
+	NodeId goal = { -1, NODE_GOAL };
+	if (pc->Search == NULL)
+	{
+		pc->Search = ASPathContextCreate(&cNodeSource, 0);
+	}
+	ASPath path = ASPathContextCreatePath(pc->Search, &sc, &start, &goal);
+	const size_t count = ASPathGetCount(path);
+	// Skip the start, and skip waypoints that are right next to the next
+	// one, i.e. our side of a chunk border
+	for (size_t i = 1; i < count; i++)
+	{
+		const Vec2i t = NodeTile(&sc, ASPathGetNode(path, i));
+		if (i + 1 < count)
+		{
+			const Vec2i next = NodeTile(&sc, ASPathGetNode(path, i + 1));
+			if (CHEBYSHEV_DISTANCE(t.x, t.y, next.x, next.y) <= 1)
+			{
+				continue;
+			}
+		}
+		CArrayPushBack(waypoints, &t);
+	}
+	ASPathDestroy(path);
+	LOG(LM_PATH, LL_TRACE, "chunk path (%d, %d) to (%d, %d): %d waypoints",
+		from.x, from.y, to.x, to.y, (int)waypoints->size);
+	return waypoints->size > 0;
+}
@@ -0,0 +1,92 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "AStar.h"
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Hierarchical pathfinding (HPA*)
+// The map is divided into square chunks; entrances are placed where
+// walkable tiles cross chunk borders, and the costs between entrances of
+// the same chunk are precomputed. Long paths are found on this much
+// smaller graph first, giving a list of waypoints which can be refined
+// into tile paths one at a time, as the actor reaches them.
+
+#define PATH_CHUNK_SIZE 16
+
+typedef struct
+{
+	int To;	// index of node in the same chunk
+	float Cost;
+} PathChunkEdge;
+typedef struct
+{
+	Vec2i Tile;
+	// Tile on the other side of the chunk border
+	Vec2i Partner;
+	CArray Edges;	// of PathChunkEdge
+} PathChunkNode;
+typedef struct
+{
+	CArray Nodes;	// of PathChunkNode
+	// Keycards needed for doors in this chunk
+	int KeyMask;
+	bool IsDirty;
+} PathChunk;
+typedef struct
+{
+	Map *map;
+	Vec2i Size;		// in chunks
+	CArray Chunks;	// of PathChunk
+	bool HasDirty;
+	// Reused for each search
+	ASPathContext Search;
+} PathChunks;
+
+void PathChunksInit(PathChunks *pc, Map *m);
+void PathChunksTerminate(PathChunks *pc);
+
+// Rebuild the chunks that need it
+void PathChunksUpdate(PathChunks *pc);
+// Mark the chunk containing a tile as needing a rebuild,
+// e.g. when the tile's walkability changes
+void PathChunksInvalidateTile(PathChunks *pc, const Vec2i tile);
+// Mark chunks with doors that use these keys as needing a rebuild
+void PathChunksInvalidateKeys(PathChunks *pc, const int keyFlags);
+
+// Find a rough path between two tiles, as a list of waypoint tiles ending
+// with the goal. Dirty chunks are rebuilt first.
+// Returns false if the tiles are close (a normal tile path should be used
+// instead) or there is no path.
+bool PathChunksFindWaypoints(
+	PathChunks *pc, const Vec2i from, const Vec2i to, CArray *waypoints);
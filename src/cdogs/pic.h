@@ -27,6 +27,8 @@
 
 #include <SDL_surface.h>
 
+#include "color.h"
+#include "sys_specifics.h"
 #include "vector.h"
 
 typedef struct
@@ -42,10 +44,24 @@ color_t PixelToColor(
 	const SDL_PixelFormat *f, const Uint8 aShift, const Uint32 pixel);
 Uint32 ColorToPixel(
 	const SDL_PixelFormat *f, const Uint8 aShift, const color_t color);
-#define PIXEL2COLOR(_p) \
-	PixelToColor(gGraphicsDevice.Format, gGraphicsDevice.Format->Ashift, _p)
-#define COLOR2PIXEL(_c) \
-	ColorToPixel(gGraphicsDevice.Format, gGraphicsDevice.Format->Ashift, _c)
+// The graphics device format is always ARGB8888 (see GraphicsInitialize),
+// so convert with fixed shifts instead of going through SDL
+static inline color_t PixelARGB8888ToColor(const Uint32 pixel)
+{
+	color_t c;
+	c.r = (uint8_t)(pixel >> 16);
+	c.g = (uint8_t)(pixel >> 8);
+	c.b = (uint8_t)pixel;
+	c.a = (uint8_t)(pixel >> 24);
+	return c;
+}
+static inline Uint32 ColorToPixelARGB8888(const color_t c)
+{
+	return ((Uint32)c.a << 24) | ((Uint32)c.r << 16) | ((Uint32)c.g << 8) |
+		c.b;
+}
+#define PIXEL2COLOR(_p) PixelARGB8888ToColor(_p)
+#define COLOR2PIXEL(_c) ColorToPixelARGB8888(_c)
 
 void PicLoad(
 	Pic *p, const Vec2i size, const Vec2i offset, const SDL_Surface *image);
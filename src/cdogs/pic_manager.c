@@ -560,6 +560,7 @@ static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p)
 	CMALLOC(n, sizeof *n);
 	if (p != NULL) n->pic = *p;
 	CSTRDUP(n->name, name);
+	n->fogged = NULL;
 	const int error = hashmap_put(pics, name, n);
 	if (error != MAP_OK)
 	{
@@ -125,7 +125,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = a->PlayerUID;
 			e.u.Score.Score = p->class->u.Score;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			sound = "pickup";
 			UpdateMissionObjective(
 				&gMission, p->tileItem.flags, OBJECTIVE_COLLECT, 1);
@@ -143,7 +143,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			e.u.Heal.PlayerUID = a->PlayerUID;
 			e.u.Heal.Amount = p->class->u.Health;
 			e.u.Heal.IsRandomSpawned = p->IsRandomSpawned;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 
@@ -181,7 +181,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			e.u.AddAmmo.Amount = p->class->u.Ammo.Amount;
 			e.u.AddAmmo.IsRandomSpawned = p->IsRandomSpawned;
 			// Note: receiving end will prevent ammo from exceeding max
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 
 			sound = ammo->Sound;
 		}
@@ -192,7 +192,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			GameEvent e = GameEventNew(GAME_EVENT_ADD_KEYS);
 			e.u.AddKeys.KeyFlags = p->class->u.Keys;
 			e.u.AddKeys.Pos = Vec2i2Net(actorPos);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 
@@ -207,7 +207,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			CASSERT(e.u.ActorReplaceGun.GunIdx <= a->guns.size,
 				"invalid replace gun index");
 			strcpy(e.u.ActorReplaceGun.Gun, gun->name);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 
 			// If the player has less ammo than the default amount,
 			// replenish up to this amount
@@ -225,7 +225,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 					e.u.AddAmmo.AmmoId = ammoId;
 					e.u.AddAmmo.Amount = ammoDeficit;
 					e.u.AddAmmo.IsRandomSpawned = false;
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 			}
 		}
@@ -247,12 +247,12 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			strcpy(es.u.SoundAt.Sound, sound);
 			es.u.SoundAt.Pos = Vec2i2Net(actorPos);
 			es.u.SoundAt.IsHit = false;
-			GameEventsEnqueue(&gGameEvents, es);
+			GameEventsEnqueue(&gGameEvents, &es);
 		}
 		GameEvent e = GameEventNew(GAME_EVENT_REMOVE_PICKUP);
 		e.u.RemovePickup.UID = p->UID;
 		e.u.RemovePickup.SpawnerUID = p->SpawnerUID;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		// Prevent multiple pickups by marking
 		p->PickedUp = true;
 	}
@@ -53,6 +53,8 @@ void PlayerDataAddOrUpdate(const NPlayerData pd)
 		memset(&pNew, 0, sizeof pNew);
 		CArrayPushBack(&gPlayerDatas, &pNew);
 		p = CArrayGet(&gPlayerDatas, (int)gPlayerDatas.size - 1);
+		// Player data may have been reallocated
+		ActorsRefreshPlayerCharacters();
 
 		// Set defaults
 		p->ActorUID = -1;
@@ -115,6 +117,7 @@ void PlayerRemove(const int uid)
 	}
 	PlayerTerminate(p);
 	CArrayDelete(&gPlayerDatas, i);
+	ActorsRefreshPlayerCharacters();
 
 	LOG(LM_MAIN, LL_INFO, "remove player UID(%d)", uid);
 }
@@ -0,0 +1,178 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "thread_pool.h"
+
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+
+#include "log.h"
+#include "utils.h"
+
+ThreadPool gThreadPool;
+
+
+static int WorkerRun(void *data);
+void ThreadPoolInit(ThreadPool *tp, int numWorkers)
+{
+	memset(tp, 0, sizeof *tp);
+	CArrayInit(&tp->threads, sizeof(SDL_Thread *));
+	if (numWorkers < 0)
+	{
+		numWorkers = SDL_GetCPUCount() - 1;
+	}
+	numWorkers = CLAMP(numWorkers, 0, THREAD_POOL_MAX_WORKERS);
+	if (numWorkers == 0)
+	{
+		return;
+	}
+	tp->mutex = SDL_CreateMutex();
+	tp->workCond = SDL_CreateCond();
+	tp->doneCond = SDL_CreateCond();
+	if (tp->mutex == NULL || tp->workCond == NULL || tp->doneCond == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot create thread pool: %s",
+			SDL_GetError());
+		return;
+	}
+	for (int i = 0; i < numWorkers; i++)
+	{
+		SDL_Thread *t = SDL_CreateThread(WorkerRun, "worker", tp);
+		if (t == NULL)
+		{
+			LOG(LM_MAIN, LL_WARN, "cannot create worker thread: %s",
+				SDL_GetError());
+			break;
+		}
+		CArrayPushBack(&tp->threads, &t);
+	}
+	LOG(LM_MAIN, LL_INFO, "started %d worker threads", (int)tp->threads.size);
+}
+void ThreadPoolTerminate(ThreadPool *tp)
+{
+	if (tp->mutex != NULL)
+	{
+		SDL_LockMutex(tp->mutex);
+		tp->quit = true;
+		SDL_CondBroadcast(tp->workCond);
+		SDL_UnlockMutex(tp->mutex);
+	}
+	CA_FOREACH(SDL_Thread *, t, tp->threads)
+		SDL_WaitThread(*t, NULL);
+	CA_FOREACH_END()
+	CArrayTerminate(&tp->threads);
+	SDL_DestroyCond(tp->doneCond);
+	SDL_DestroyCond(tp->workCond);
+	SDL_DestroyMutex(tp->mutex);
+	memset(tp, 0, sizeof *tp);
+}
+
+static void RunJobs(ThreadPool *tp)
+{
+	for (;;)
+	{
+		const int start = SDL_AtomicAdd(&tp->next, tp->chunk);
+		if (start >= tp->count)
+		{
+			break;
+		}
+		const int end = MIN(start + tp->chunk, tp->count);
+		for (int i = start; i < end; i++)
+		{
+			tp->func(tp->data, i);
+		}
+	}
+}
+
+static int WorkerRun(void *data)
+{
+	ThreadPool *tp = data;
+	int generation = 0;
+	SDL_LockMutex(tp->mutex);
+	for (;;)
+	{
+		while (!tp->quit && tp->generation == generation)
+		{
+			SDL_CondWait(tp->workCond, tp->mutex);
+		}
+		if (tp->quit)
+		{
+			break;
+		}
+		generation = tp->generation;
+		SDL_UnlockMutex(tp->mutex);
+
+		RunJobs(tp);
+
+		SDL_LockMutex(tp->mutex);
+		tp->busy--;
+		if (tp->busy == 0)
+		{
+			SDL_CondSignal(tp->doneCond);
+		}
+	}
+	SDL_UnlockMutex(tp->mutex);
+	return 0;
+}
+
+void ThreadPoolParallelFor(
+	ThreadPool *tp, ThreadPoolJobFunc func, void *data, const int count)
+{
+	if (tp->threads.size == 0 || count <= 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			func(data, i);
+		}
+		return;
+	}
+
+	SDL_LockMutex(tp->mutex);
+	tp->func = func;
+	tp->data = data;
+	tp->count = count;
+	// Use small chunks so that the work evens out between threads, but not
+	// so small that the shared counter is contended
+	const int numThreads = (int)tp->threads.size + 1;
+	tp->chunk = MAX(1, count / (numThreads * 4));
+	SDL_AtomicSet(&tp->next, 0);
+	tp->busy = (int)tp->threads.size;
+	tp->generation++;
+	SDL_CondBroadcast(tp->workCond);
+	SDL_UnlockMutex(tp->mutex);
+
+	// Help out while waiting
+	RunJobs(tp);
+
+	SDL_LockMutex(tp->mutex);
+	while (tp->busy > 0)
+	{
+		SDL_CondWait(tp->doneCond, tp->mutex);
+	}
+	SDL_UnlockMutex(tp->mutex);
+}
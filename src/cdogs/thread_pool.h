@@ -0,0 +1,77 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_atomic.h>
+#include <SDL_mutex.h>
+
+#include "c_array.h"
+
+// Maximum number of worker threads, not including the main thread
+#define THREAD_POOL_MAX_WORKERS 7
+
+// A job is called once per index; jobs for different indices may run
+// concurrently so they must only write to their own per-index data
+typedef void (*ThreadPoolJobFunc)(void *data, const int index);
+
+// Fixed pool of worker threads for running data-parallel jobs
+// Workers claim chunks of indices from a shared counter so busy workers
+// are not left waiting on slow ones (basic work stealing).
+typedef struct
+{
+	CArray threads;	// of SDL_Thread *
+	SDL_mutex *mutex;
+	SDL_cond *workCond;
+	SDL_cond *doneCond;
+	bool quit;
+	int generation;
+	int busy;
+
+	// Current batch
+	ThreadPoolJobFunc func;
+	void *data;
+	int count;
+	int chunk;
+	SDL_atomic_t next;
+} ThreadPool;
+
+extern ThreadPool gThreadPool;
+
+// Start the pool with the number of workers; use a negative number to
+// pick one based on the number of CPUs.
+// If the pool has no workers, jobs are run serially on the calling thread.
+void ThreadPoolInit(ThreadPool *tp, int numWorkers);
+void ThreadPoolTerminate(ThreadPool *tp);
+
+// Call func(data, i) for i in [0, count), on the calling thread and all
+// workers, and return once every index has been processed
+void ThreadPoolParallelFor(
+	ThreadPool *tp, ThreadPoolJobFunc func, void *data, const int count);
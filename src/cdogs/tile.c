@@ -65,14 +65,14 @@ void TileInit(Tile *t)
 {
 	memset(t, 0, sizeof *t);
 	CArrayInit(&t->triggers, sizeof(Trigger *));
-	CArrayInit(&t->things, sizeof(ThingId));
+	t->things.Id = -1;
+	t->thingsLast.Id = -1;
 	t->pic = NULL;
 	t->picAlt = NULL;
 }
 void TileDestroy(Tile *t)
 {
 	CArrayTerminate(&t->triggers);
-	CArrayTerminate(&t->things);
 }
 
 bool IsTileItemInsideTile(TTileItem *i, Vec2i tilePos)
@@ -102,19 +102,19 @@ bool TileIsClear(const Tile *t)
 	const int normalFloorFlags = MAPTILE_IS_NORMAL_FLOOR | MAPTILE_OFFSET_PIC;
 	if (t->flags & ~normalFloorFlags) return false;
 	// Check if tile has no things on it, excluding particles
-	CA_FOREACH(const ThingId, tid, t->things)
-		if (tid->Kind != KIND_PARTICLE) return false;
-	CA_FOREACH_END()
+	TILE_FOREACH_THING(t, ti)
+		if (ti->kind != KIND_PARTICLE) return false;
+	TILE_FOREACH_THING_END()
 	return true;
 }
 bool TileHasCharacter(Tile *t)
 {
-	CA_FOREACH(const ThingId, tid, t->things)
-		if (tid->Kind == KIND_CHARACTER)
+	TILE_FOREACH_THING(t, ti)
+		if (ti->kind == KIND_CHARACTER)
 		{
 			return true;
 		}
-	CA_FOREACH_END()
+	TILE_FOREACH_THING_END()
 	return false;
 }
 
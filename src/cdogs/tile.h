@@ -98,6 +98,12 @@ typedef enum
 #define OBJECTIVE_SHIFT         3
 
 
+typedef struct
+{
+	int Id;
+	TileItemKind Kind;
+} ThingId;
+
 typedef const Pic *(*TileItemGetPicFunc)(int, Vec2i *);
 
 typedef struct
@@ -130,15 +136,13 @@ typedef struct TileItem
 	GetDrawContextFunc CPicFunc;
 	Vec2i ShadowSize;
 	int SoundLock;
+	// Links to the other things on the same tile; Id < 0 if none
+	ThingId tilePrev;
+	ThingId tileNext;
 } TTileItem;
 #define SOUND_LOCK_TILE_OBJECT 12
 
 
-typedef struct
-{
-	int Id;
-	TileItemKind Kind;
-} ThingId;
 typedef struct
 {
 	// Note: use NamedPic so we can serialise over net using name
@@ -147,9 +151,22 @@ typedef struct
 	int flags;
 	bool isVisited;
 	CArray triggers;	// of Trigger *
-	CArray things;		// of ThingId
+	// First and last of the things on this tile, in the order they were
+	// added, linked by TTileItem tileNext; Id < 0 if the tile is empty
+	ThingId things;
+	ThingId thingsLast;
 } Tile;
 
+// Iterate over the things on a tile
+// The next thing is fetched before the body, so the current thing can be
+// removed from the tile
+#define TILE_FOREACH_THING(_tile, _ti)\
+	for (ThingId _tile_next = (_tile)->things; _tile_next.Id >= 0;)\
+	{\
+		TTileItem *_ti = ThingIdGetTileItem(&_tile_next);\
+		_tile_next = _ti->tileNext;
+#define TILE_FOREACH_THING_END() }
+
 
 Tile TileNone(void);
 void TileInit(Tile *t);
@@ -58,6 +58,26 @@
 CArray gWatches;	// of TWatch
 static int watchIndex = 1;
 
+// Watches are evaluated only when the tiles of their conditions change.
+// Condition tiles, sorted by position, so that tile changes can find the
+// conditions to re-evaluate
+typedef struct
+{
+	Vec2i Pos;
+	int Watch;
+	int Condition;
+} WatchedTile;
+static CArray sWatchedTiles;	// of WatchedTile
+static bool sWatchedTilesSorted;
+// Indices of active watches with conditions to re-evaluate
+static CArray sDirtyWatches;	// of int
+// Indices of active watches with all conditions fulfilled
+static CArray sArmedWatches;	// of int
+static CArray sArmedWatchesScratch;	// of int
+static int sActiveWatches;
+// Total ticks that watches have been updated
+static int sWatchTime;
+
 
 Trigger *TriggerNew(void)
 {
@@ -101,6 +121,7 @@ Condition *WatchAddCondition(
 	c.CounterMax = counterMax;
 	c.Pos = pos;
 	CArrayPushBack(&w->conditions, &c);
+	sWatchedTilesSorted = false;
 	return CArrayGet(&w->conditions, w->conditions.size - 1);
 }
 Action *WatchAddAction(TWatch *w)
@@ -111,19 +132,28 @@ Action *WatchAddAction(TWatch *w)
 	return CArrayGet(&w->actions, w->actions.size - 1);
 }
 
+static void MarkWatchDirty(TWatch *w, const int watchIdx);
+static void DisarmWatch(TWatch *w, const int watchIdx);
 static void ActivateWatch(int idx)
 {
 	CA_FOREACH(TWatch, w, gWatches)
 		if (w->index == idx)
 		{
+			if (!w->active)
+			{
+				sActiveWatches++;
+			}
 			w->active = true;
+			DisarmWatch(w, _ca_index);
 
 			// Reset all conditions related to watch
 			for (int j = 0; j < (int)w->conditions.size; j++)
 			{
 				Condition *c = CArrayGet(&w->conditions, j);
-				c->Counter = 0;
+				c->IsMet = false;
+				c->IsDirty = true;
 			}
+			MarkWatchDirty(w, _ca_index);
 			return;
 		}
 	CA_FOREACH_END()
@@ -135,16 +165,51 @@ static void DeactivateWatch(int idx)
 	CA_FOREACH(TWatch, w, gWatches)
 		if (w->index == idx)
 		{
+			if (w->active)
+			{
+				sActiveWatches--;
+			}
 			w->active = false;
+			DisarmWatch(w, _ca_index);
 			return;
 		}
 	CA_FOREACH_END()
 	CASSERT(false, "Cannot find watch");
 }
+static void MarkWatchDirty(TWatch *w, const int watchIdx)
+{
+	if (!w->IsDirty)
+	{
+		w->IsDirty = true;
+		CArrayPushBack(&sDirtyWatches, &watchIdx);
+	}
+}
+static void DisarmWatch(TWatch *w, const int watchIdx)
+{
+	if (!w->IsArmed)
+	{
+		return;
+	}
+	w->IsArmed = false;
+	CA_FOREACH(const int, armedIdx, sArmedWatches)
+		if (*armedIdx == watchIdx)
+		{
+			CArrayDelete(&sArmedWatches, _ca_index);
+			break;
+		}
+	CA_FOREACH_END()
+}
 
 void WatchesInit(void)
 {
 	CArrayInit(&gWatches, sizeof(TWatch));
+	CArrayInit(&sWatchedTiles, sizeof(WatchedTile));
+	sWatchedTilesSorted = true;
+	CArrayInit(&sDirtyWatches, sizeof(int));
+	CArrayInit(&sArmedWatches, sizeof(int));
+	CArrayInit(&sArmedWatchesScratch, sizeof(int));
+	sActiveWatches = 0;
+	sWatchTime = 0;
 }
 void WatchesTerminate(void)
 {
@@ -153,6 +218,11 @@ void WatchesTerminate(void)
 		CArrayTerminate(&w->actions);
 	CA_FOREACH_END()
 	CArrayTerminate(&gWatches);
+	CArrayTerminate(&sWatchedTiles);
+	CArrayTerminate(&sDirtyWatches);
+	CArrayTerminate(&sArmedWatches);
+	CArrayTerminate(&sArmedWatchesScratch);
+	sActiveWatches = 0;
 }
 
 static void ActionRun(Action *a, CArray *mapTriggers)
@@ -187,7 +257,7 @@ static void ActionRun(Action *a, CArray *mapTriggers)
 		break;
 
 	case ACTION_EVENT:
-		GameEventsEnqueue(&gGameEvents, a->a.Event);
+		GameEventsEnqueue(&gGameEvents, &a->a.Event);
 		break;
 
 	case ACTION_ACTIVATEWATCH:
@@ -204,32 +274,54 @@ static void ActionRun(Action *a, CArray *mapTriggers)
 	}
 }
 
-static bool ConditionsMet(CArray *conditions, const int ticks)
+static bool ConditionIsMet(const Condition *c)
 {
-	bool allConditionsMet = true;
-	for (int i = 0; i < (int)conditions->size; i++)
+	switch (c->Type)
 	{
-		Condition *c = CArrayGet(conditions, i);
-		bool conditionMet = false;
-		switch (c->Type)
-		{
-		case CONDITION_TILECLEAR:
-			conditionMet = TileIsClear(MapGetTile(&gMap, c->Pos));
-			break;
-		}
-		if (conditionMet)
+	case CONDITION_TILECLEAR:
+		return TileIsClear(MapGetTile(&gMap, c->Pos));
+	default:
+		CASSERT(false, "unknown condition type");
+		return false;
+	}
+}
+// Re-evaluate the watch's changed conditions, and arm it if all of them
+// are fulfilled
+static void EvaluateConditions(TWatch *w, const int watchIdx)
+{
+	bool allConditionsMet = true;
+	int dueTime = 0;
+	CA_FOREACH(Condition, c, w->conditions)
+		if (c->IsDirty)
 		{
-			c->Counter += ticks;
-			allConditionsMet =
-				allConditionsMet && c->Counter >= c->CounterMax;
+			c->IsDirty = false;
+			const bool isMet = ConditionIsMet(c);
+			if (isMet && !c->IsMet)
+			{
+				// Count from the start of this update, as if the
+				// condition's ticks were accumulated this update
+				c->MetSince = sWatchTime;
+			}
+			c->IsMet = isMet;
 		}
-		else
+		if (!c->IsMet)
 		{
-			c->Counter = 0;
 			allConditionsMet = false;
+			continue;
 		}
+		dueTime = MAX(dueTime, c->MetSince + c->CounterMax);
+	CA_FOREACH_END()
+	if (!allConditionsMet)
+	{
+		DisarmWatch(w, watchIdx);
+		return;
+	}
+	w->DueTime = dueTime;
+	if (!w->IsArmed)
+	{
+		w->IsArmed = true;
+		CArrayPushBack(&sArmedWatches, &watchIdx);
 	}
-	return allConditionsMet;
 }
 
 bool TriggerCanActivate(const Trigger *t, const int flags)
@@ -246,14 +338,103 @@ void TriggerActivate(Trigger *t, CArray *mapTriggers)
 
 void UpdateWatches(CArray *mapTriggers, const int ticks)
 {
-	CA_FOREACH(TWatch, w, gWatches)
+	// Re-evaluate watches whose tiles have changed
+	CA_FOREACH(const int, watchIdx, sDirtyWatches)
+		TWatch *w = CArrayGet(&gWatches, *watchIdx);
+		w->IsDirty = false;
 		if (!w->active) continue;
-		if (ConditionsMet(&w->conditions, ticks))
+		EvaluateConditions(w, *watchIdx);
+	CA_FOREACH_END()
+	CArrayClear(&sDirtyWatches);
+
+	sWatchTime += ticks;
+
+	// Run watches whose conditions have been fulfilled for long enough;
+	// actions can activate or deactivate watches, so iterate over a copy
+	CArrayClear(&sArmedWatchesScratch);
+	CA_FOREACH(const int, watchIdx, sArmedWatches)
+		CArrayPushBack(&sArmedWatchesScratch, watchIdx);
+	CA_FOREACH_END()
+	CA_FOREACH(const int, watchIdx, sArmedWatchesScratch)
+		TWatch *w = CArrayGet(&gWatches, *watchIdx);
+		if (!w->active || !w->IsArmed || sWatchTime < w->DueTime) continue;
+		for (int j = 0; j < (int)w->actions.size; j++)
 		{
-			for (int j = 0; j < (int)w->actions.size; j++)
-			{
-				ActionRun(CArrayGet(&w->actions, j), mapTriggers);
-			}
+			ActionRun(CArrayGet(&w->actions, j), mapTriggers);
+		}
+	CA_FOREACH_END()
+}
+
+static int CompareWatchedTiles(const void *v1, const void *v2);
+static void SortWatchedTiles(void)
+{
+	CArrayClear(&sWatchedTiles);
+	CA_FOREACH(const TWatch, w, gWatches)
+		for (int j = 0; j < (int)w->conditions.size; j++)
+		{
+			const Condition *c = CArrayGet(&w->conditions, j);
+			WatchedTile wt;
+			wt.Pos = c->Pos;
+			wt.Watch = _ca_index;
+			wt.Condition = j;
+			CArrayPushBack(&sWatchedTiles, &wt);
 		}
 	CA_FOREACH_END()
+	qsort(
+		sWatchedTiles.data, sWatchedTiles.size, sWatchedTiles.elemSize,
+		CompareWatchedTiles);
+	sWatchedTilesSorted = true;
+}
+static int CompareWatchedTiles(const void *v1, const void *v2)
+{
+	const WatchedTile *a = v1;
+	const WatchedTile *b = v2;
+	if (a->Pos.y != b->Pos.y) return a->Pos.y < b->Pos.y ? -1 : 1;
+	if (a->Pos.x != b->Pos.x) return a->Pos.x < b->Pos.x ? -1 : 1;
+	return 0;
+}
+void WatchesOnTileChanged(const Vec2i pos)
+{
+	// Nothing to do if no watches are listening
+	if (sActiveWatches == 0)
+	{
+		return;
+	}
+	if (!sWatchedTilesSorted)
+	{
+		SortWatchedTiles();
+	}
+	// Find the first watched tile at the position
+	const WatchedTile key = { pos, 0, 0 };
+	int lo = 0;
+	int hi = (int)sWatchedTiles.size;
+	while (lo < hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if (CompareWatchedTiles(
+			CArrayGet(&sWatchedTiles, mid), &key) < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	for (int i = lo; i < (int)sWatchedTiles.size; i++)
+	{
+		const WatchedTile *wt = CArrayGet(&sWatchedTiles, i);
+		if (!Vec2iEqual(wt->Pos, pos))
+		{
+			break;
+		}
+		TWatch *w = CArrayGet(&gWatches, wt->Watch);
+		if (!w->active)
+		{
+			continue;
+		}
+		Condition *c = CArrayGet(&w->conditions, wt->Condition);
+		c->IsDirty = true;
+		MarkWatchDirty(w, wt->Watch);
+	}
 }
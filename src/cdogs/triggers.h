@@ -100,9 +100,13 @@ typedef enum
 typedef struct
 {
 	ConditionType Type;
-	// How many ticks has this condition been fulfilled
-	// Reset to 0 when condition failed
-	int Counter;
+	// Whether the condition was fulfilled when last evaluated
+	bool IsMet;
+	// Set when the condition's tile changes, to re-evaluate it
+	bool IsDirty;
+	// Watch time since which this condition has been fulfilled
+	int MetSince;
+	// How many ticks the condition needs to be fulfilled
 	int CounterMax;
 	Vec2i Pos;
 } Condition;
@@ -114,12 +118,19 @@ typedef struct
 	CArray conditions;	// of Condition
 	CArray actions;		// of Action
 	bool active;
+	// Has conditions to re-evaluate
+	bool IsDirty;
+	// All conditions are fulfilled; run the actions once DueTime is reached
+	bool IsArmed;
+	int DueTime;
 } TWatch;
 
 
 bool TriggerCanActivate(const Trigger *t, const int flags);
 void TriggerActivate(Trigger *t, CArray *mapTriggers);
 void UpdateWatches(CArray *mapTriggers, const int ticks);
+// Notify that the tile's contents or flags have changed
+void WatchesOnTileChanged(const Vec2i pos);
 Trigger *TriggerNew(void);
 void TriggerTerminate(Trigger *t);
 Action *TriggerAddAction(Trigger *t);
@@ -473,7 +473,7 @@ void GunFire(
 	e.u.GunFire.Sound = playSound;
 	e.u.GunFire.Flags = flags;
 	e.u.GunFire.IsGun = isGun;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 void GunAddBrass(
@@ -501,7 +501,7 @@ void GunAddBrass(
 	e.u.AddParticle.Angle = RAND_DOUBLE(0, PI * 2);
 	e.u.AddParticle.DZ = (rand() % 6) + 6;
 	e.u.AddParticle.Spin = RAND_DOUBLE(-0.1, 0.1);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 static Vec2i GetMuzzleOffset(const direction_e d);
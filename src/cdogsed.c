@@ -60,9 +60,11 @@
 #include <cdogs/automap.h>
 #include <cdogs/collision/collision.h>
 #include <cdogs/config_io.h>
+#include <cdogs/draw/actor_pic_cache.h>
 #include <cdogs/draw/draw.h>
 #include <cdogs/draw/drawtools.h>
 #include <cdogs/events.h>
+#include <cdogs/file_writer.h>
 #include <cdogs/files.h>
 #include <cdogs/font_utils.h>
 #include <cdogs/log.h>
@@ -72,6 +74,7 @@
 #include <cdogsed/char_editor.h>
 #include <cdogsed/editor_ui.h>
 #include <cdogsed/editor_ui_common.h>
+#include <cdogsed/editor_undo.h>
 
 
 // Mouse click areas:
@@ -81,7 +84,12 @@ static UIObject *sLastHighlightedObj = NULL;
 static UIObject *sTooltipObj = NULL;
 static DrawBuffer sDrawBuffer;
 static bool sJustLoaded = true;
-static bool sHasUnbakedChanges = false;
+static EditorUndo sUndo;
+// Whether the brush changed more than tiles since the last undo commit
+static bool sUndoPendingRest = false;
+// Text field with edits that are not committed yet; consecutive edits to
+// the same field are kept as one undo step
+static const UIObject *sUndoTextObj = NULL;
 static int sAutosaveIndex = 0;
 // State for whether to ignore the current mouse click
 // This is to prevent painting immediately after selecting a new tool,
@@ -95,8 +103,6 @@ static char lastFile[CDOGS_PATH_MAX];
 static EditorBrush brush;
 Vec2i camera = { 0, 0 };
 #define CAMERA_PAN_SPEED 3
-Mission currentMission;
-Mission lastMission;
 #define AUTOSAVE_INTERVAL_SECONDS 60
 Uint32 ticksAutosave;
 Uint32 sTicksElapsed;
@@ -182,15 +188,31 @@ static void Display(GraphicsDevice *g, HandleInputResult result)
 		{
 			MakeBackground(g, false);
 		}
+		GrafxDrawExtra extra;
+		extra.guideImage = brush.GuideImageSurface;
+		extra.guideImageAlpha = brush.GuideImageAlpha;
 		if (result.RemakeBg || brush.IsGuideImageNew)
 		{
 			// Clear background first
 			memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 			brush.IsGuideImageNew = false;
-			GrafxDrawExtra extra;
-			extra.guideImage = brush.GuideImageSurface;
-			extra.guideImageAlpha = brush.GuideImageAlpha;
 			GrafxDrawBackground(g, &sDrawBuffer, tintNone, camera, &extra);
+			brush.Dirty.Size = Vec2iZero();
+		}
+		else if (!Vec2iIsZero(brush.Dirty.Size))
+		{
+			// Only redraw around the tiles the brush changed.
+			// Walls and objects overhang the tiles above them, and changing
+			// a tile can change the wall pics of its neighbours.
+			const Vec2i start =
+				GetScreenPos(Vec2iMinus(brush.Dirty.Pos, Vec2iNew(1, 2)));
+			const Vec2i end = GetScreenPos(Vec2iAdd(
+				Vec2iAdd(brush.Dirty.Pos, brush.Dirty.Size), Vec2iUnit()));
+			Rect2i area;
+			area.Pos = start;
+			area.Size = Vec2iMinus(end, start);
+			GrafxDrawBackgroundArea(g, &sDrawBuffer, camera, &extra, area);
+			brush.Dirty.Size = Vec2iZero();
 		}
 		GraphicsClear(g);
 
@@ -253,16 +275,51 @@ static void Display(GraphicsDevice *g, HandleInputResult result)
 
 static void Setup(const bool changedMission);
 
+// Record the edits to the current mission as one undoable step
+static void CommitUndo(const bool changedRest)
+{
+	const Mission *m = CampaignGetCurrentMission(&gCampaign);
+	if (m == NULL || !EditorUndoIsMission(
+		&sUndo, gCampaign.MissionIndex, (int)gCampaign.Setting.Missions.size))
+	{
+		// The mission itself changed; its history starts again in Setup
+		CArrayClear(&brush.ChangedTiles);
+		return;
+	}
+	EditorUndoCommit(&sUndo, m, &brush.ChangedTiles, changedRest);
+	sUndoTextObj = NULL;
+}
+// Finish the undo step for the text field being edited, if any
+static void CommitTextUndo(void)
+{
+	if (sUndoTextObj != NULL)
+	{
+		CommitUndo(true);
+	}
+}
+// The text field that typing goes to
+static const UIObject *GetTextObj(void)
+{
+	const UIObject *o = sObjs;
+	while (o != NULL && o->Highlighted != NULL)
+	{
+		o = o->Highlighted;
+	}
+	return o;
+}
+
 static void Change(UIObject *o, const int d, const bool shift)
 {
 	if (o == NULL)
 	{
 		return;
 	}
+	CommitTextUndo();
 	const EditorResult r = UIObjectChange(o, d, shift);
 	if (r & EDITOR_RESULT_CHANGED)
 	{
 		fileChanged = true;
+		CommitUndo(true);
 	}
 	if (r & EDITOR_RESULT_CHANGED_AND_RELOAD)
 	{
@@ -391,12 +448,18 @@ static void Autosave(void)
 static void Setup(const bool changedMission)
 {
 	Mission *m = CampaignGetCurrentMission(&gCampaign);
+	const int numMissions = (int)gCampaign.Setting.Missions.size;
+	if (changedMission || m == NULL ||
+		!EditorUndoIsMission(&sUndo, gCampaign.MissionIndex, numMissions))
+	{
+		EditorUndoReset(&sUndo, m, gCampaign.MissionIndex, numMissions);
+		sUndoPendingRest = false;
+		sUndoTextObj = NULL;
+	}
 	if (!m)
 	{
 		return;
 	}
-	MissionCopy(&lastMission, &currentMission);
-	MissionCopy(&currentMission, m);
 	MissionOptionsTerminate(&gMission);
 	CampaignAndMissionSetup(&gCampaign, &gMission);
 	MakeBackground(&gGraphicsDevice, changedMission);
@@ -404,7 +467,7 @@ static void Setup(const bool changedMission)
 	Autosave();
 
 	sJustLoaded = true;
-	sHasUnbakedChanges = false;
+	brush.Dirty.Size = Vec2iZero();
 }
 
 // Reload UI so that we can load new elements based on custom data etc.
@@ -635,11 +698,20 @@ static void Save(void)
 		FontStrCenter("Saving...");
 
 		BlitFlip(&gGraphicsDevice);
+		// Finish any autosaves first, so that only this save's result counts
+		FileWriterFlush(&gFileWriter);
+		char msgBuf[CDOGS_PATH_MAX];
 		MapArchiveSave(filename, &gCampaign.Setting);
+		if (!FileWriterFlush(&gFileWriter))
+		{
+			sprintf(msgBuf, "Failed to save to %s", filename);
+			SDL_ShowSimpleMessageBox(
+				SDL_MESSAGEBOX_ERROR, "Error", msgBuf, gGraphicsDevice.window);
+			return;
+		}
 		fileChanged = false;
 		strcpy(lastFile, filename);
 		sAutosaveIndex = 0;
-		char msgBuf[CDOGS_PATH_MAX];
 		sprintf(msgBuf, "Saved to %s", filename);
 		SDL_ShowSimpleMessageBox(
 			SDL_MESSAGEBOX_INFORMATION, "Campaign Saved",
@@ -694,6 +766,7 @@ static void HelpScreen(void)
 		"Ctrl+O:                         Open file\n"
 		"Ctrl+S:                         Save file\n"
 		"Ctrl+X, C, V:                   Cut/copy/paste\n"
+		"Ctrl+Z, Y:                      Undo/redo\n"
 		"Ctrl+M:                         Preview automap\n"
 		"F1:                             This screen\n";
 	ClearScreen(&gGraphicsDevice);
@@ -755,9 +828,16 @@ static void Delete(int xc, int yc)
 		break;
 	}
 	fileChanged = true;
+	CommitUndo(true);
 	Setup(changedMission);
 }
 
+// Whether the brush changes the mission beyond its static tiles
+static bool BrushChangesRest(const EditorBrush *b)
+{
+	return b->Type >= BRUSHTYPE_SET_PLAYER_START &&
+		b->Type != BRUSHTYPE_SET_KEY;
+}
 static void InputInsert(int *xc, const int yc, Mission *mission);
 static void InputDelete(const int xc, const int yc);
 static HandleInputResult HandleInput(
@@ -819,6 +899,8 @@ static HandleInputResult HandleInput(
 		MouseWheel(&gEventHandlers.mouse).y != 0))
 	{
 		result.Redraw = true;
+		// Clicking ends the edit of a text field
+		CommitTextUndo();
 		if (sLastHighlightedObj && !sLastHighlightedObj->IsBackground)
 		{
 			UITryGetObject(sLastHighlightedObj, mousePos, &o);
@@ -835,6 +917,7 @@ static HandleInputResult HandleInput(
 				{
 					if (UIObjectUnhighlight(sLastHighlightedObj, true))
 					{
+						CommitUndo(true);
 						Setup(false);
 					}
 				}
@@ -903,8 +986,10 @@ static HandleInputResult HandleInput(
 				{
 					fileChanged = true;
 					Autosave();
-					result.RemakeBg = true;
-					sHasUnbakedChanges = true;
+					// Tiles the brush marked are redrawn on their own
+					result.RemakeBg = Vec2iIsZero(brush.Dirty.Size);
+					sUndoPendingRest =
+						sUndoPendingRest || BrushChangesRest(&brush);
 				}
 				if (r & EDITOR_RESULT_RELOAD)
 				{
@@ -927,8 +1012,15 @@ static HandleInputResult HandleInput(
 				fileChanged = true;
 				Autosave();
 				result.Redraw = true;
-				result.RemakeBg = true;
-				sHasUnbakedChanges = true;
+				result.RemakeBg = Vec2iIsZero(brush.Dirty.Size);
+				sUndoPendingRest =
+					sUndoPendingRest || BrushChangesRest(&brush);
+			}
+			// The stroke has ended; keep it as one undo step
+			if (brush.ChangedTiles.size > 0 || sUndoPendingRest)
+			{
+				CommitUndo(sUndoPendingRest);
+				sUndoPendingRest = false;
 			}
 			if (r & EDITOR_RESULT_RELOAD)
 			{
@@ -981,34 +1073,25 @@ static HandleInputResult HandleInput(
 		switch (kc)
 		{
 		case 'z':
-			// Undo
-			// Do this by swapping the current mission with the last mission
-			// This requires a bit of copy-acrobatics; because missions
-			// are saved in Setup(), but by this stage the mission has already
-			// changed, _two_ mission caches are used, copied in sequence.
-			// That is, if the current mission is at state B, the first cache
-			// is still at state B (copied after the mission has changed
-			// already), and the second cache is at state A.
-			// If we were to perform an undo and still maintain functionality,
-			// we need to copy such that the states change from B,B,A to
-			// A,A,B.
-
-			// However! The above is true only if we have "baked" changes
-			// The editor has been optimised to perform some changes
-			// without reloading map files; that is, the files are actually
-			// in states C,B,A.
-			// In this case, another set of "acrobatics" is required
-			if (sHasUnbakedChanges)
-			{
-				MissionCopy(&lastMission, mission);	// B,A,Z -> B,A,B
-			}
-			else
+		case 'y':
+			if (mission != NULL)
 			{
-				MissionCopy(mission, &lastMission);	// B,B,A -> A,B,A
-				MissionCopy(&lastMission, &currentMission);	// A,B,A -> A,B,B
+				// Commit anything pending so that it is undone first
+				CommitUndo(sUndoPendingRest || sUndoTextObj != NULL);
+				sUndoPendingRest = false;
+				const EditorResult r = kc == 'z' ?
+					EditorUndoUndo(&sUndo, mission, &brush) :
+					EditorUndoRedo(&sUndo, mission, &brush);
+				if (r & EDITOR_RESULT_CHANGED)
+				{
+					fileChanged = true;
+					result.RemakeBg = Vec2iIsZero(brush.Dirty.Size);
+				}
+				if (r & EDITOR_RESULT_RELOAD)
+				{
+					Setup(false);
+				}
 			}
-			fileChanged = true;
-			Setup(false);	// A,B,B -> A,A,B
 			break;
 
 		case 'x':
@@ -1075,6 +1158,7 @@ static HandleInputResult HandleInput(
 			CharEditor(
 				&gGraphicsDevice, &gCampaign.Setting, &gEventHandlers,
 				&fileChanged);
+			CommitUndo(true);
 			Setup(false);
 			UIObjectUnhighlight(sObjs, true);
 			CArrayTerminate(&sDrawObjs);
@@ -1130,7 +1214,15 @@ static HandleInputResult HandleInput(
 			break;
 
 		case SDL_SCANCODE_BACKSPACE:
-			fileChanged = UIObjectDelChar(sObjs) || fileChanged;
+			if (GetTextObj() != sUndoTextObj)
+			{
+				CommitTextUndo();
+			}
+			if (UIObjectDelChar(sObjs))
+			{
+				fileChanged = true;
+				sUndoTextObj = GetTextObj();
+			}
 			break;
 
 		default:
@@ -1141,7 +1233,15 @@ static HandleInputResult HandleInput(
 		char *c = gEventHandlers.keyboard.Typed;
 		while (c && *c >= ' ' && *c <= '~')
 		{
-			fileChanged = UIObjectAddChar(sObjs, *c) || fileChanged;
+			if (GetTextObj() != sUndoTextObj)
+			{
+				CommitTextUndo();
+			}
+			if (UIObjectAddChar(sObjs, *c))
+			{
+				fileChanged = true;
+				sUndoTextObj = GetTextObj();
+			}
 			c++;
 		}
 	}
@@ -1228,6 +1328,7 @@ static void InputInsert(int *xc, const int yc, Mission *mission)
 		break;
 	}
 	fileChanged = true;
+	CommitUndo(true);
 	Setup(changedMission);
 }
 static void InputDelete(const int xc, const int yc)
@@ -1313,9 +1414,11 @@ int main(int argc, char *argv[])
 
 	EditorBrushInit(&brush);
 	strcpy(lastFile, "");
+	FileWriterInit(&gFileWriter);
 
 	gConfig = ConfigLoad(GetConfigFilePath(CONFIG_FILE));
 	PicManagerInit(&gPicManager);
+	ActorPicCacheInit(&gActorPicCache, ACTOR_PIC_CACHE_MEMORY);
 	// Hardcode config settings
 	ConfigGet(&gConfig, "Graphics.ScaleFactor")->u.Int.Value = 2;
 	ConfigGet(&gConfig, "Graphics.ScaleMode")->u.Enum.Value = SCALE_MODE_NN;
@@ -1349,8 +1452,9 @@ int main(int argc, char *argv[])
 		&gMapObjects, "data/map_objects.json", &gAmmo, &gGunDescriptions);
 	CollisionSystemInit(&gCollisionSystem);
 	CampaignInit(&gCampaign);
-	MissionInit(&lastMission);
-	MissionInit(&currentMission);
+	EditorUndoInit(
+		&sUndo,
+		(size_t)ConfigGetInt(&gConfig, "Editor.UndoMemory") * 1024 * 1024);
 
 	// initialise UI collections
 	// Note: must do this after text init since positions depend on text height
@@ -1398,13 +1502,13 @@ int main(int argc, char *argv[])
 	BulletTerminate(&gBulletClasses);
 	CharacterClassesTerminate(&gCharacterClasses);
 	CampaignTerminate(&gCampaign);
-	MissionTerminate(&lastMission);
-	MissionTerminate(&currentMission);
+	EditorUndoTerminate(&sUndo);
 	CollisionSystemTerminate(&gCollisionSystem);
 
 	DrawBufferTerminate(&sDrawBuffer);
 	GraphicsTerminate(&gGraphicsDevice);
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
+	ActorPicCacheTerminate(&gActorPicCache);
 	PicManagerTerminate(&gPicManager);
 	FontTerminate(&gFont);
 
@@ -1413,6 +1517,7 @@ int main(int argc, char *argv[])
 	EditorBrushTerminate(&brush);
 
 	ConfigDestroy(&gConfig);
+	FileWriterTerminate(&gFileWriter);
 	LogTerminate();
 
 	SDL_Quit();
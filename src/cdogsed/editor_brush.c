@@ -33,6 +33,7 @@
 #include <cdogs/map.h>
 #include <cdogs/map_build.h>
 #include <cdogs/mission_convert.h>
+#include <cdogs/objs.h>
 
 
 void EditorBrushInit(EditorBrush *b)
@@ -49,10 +50,12 @@ void EditorBrushInit(EditorBrush *b)
 	b->Pos = Vec2iNew(-1, -1);
 	b->GuideImageAlpha = 64;
 	CArrayInit(&b->HighlightedTiles, sizeof(Vec2i));
+	CArrayInit(&b->ChangedTiles, sizeof(int));
 }
 void EditorBrushTerminate(EditorBrush *b)
 {
 	CArrayTerminate(&b->HighlightedTiles);
+	CArrayTerminate(&b->ChangedTiles);
 	SDL_FreeSurface(b->GuideImageSurface);
 }
 
@@ -200,11 +203,30 @@ void EditorBrushSetHighlightedTiles(EditorBrush *b)
 	}
 }
 
-static void SetTile(Mission *m, Vec2i pos, unsigned short tile)
+void EditorBrushMarkDirty(EditorBrush *b, const Vec2i pos)
+{
+	if (Vec2iIsZero(b->Dirty.Size))
+	{
+		b->Dirty.Pos = pos;
+		b->Dirty.Size = Vec2iUnit();
+		return;
+	}
+	const Vec2i start = Vec2iMin(b->Dirty.Pos, pos);
+	const Vec2i end = Vec2iMax(
+		Vec2iAdd(b->Dirty.Pos, b->Dirty.Size), Vec2iAdd(pos, Vec2iUnit()));
+	b->Dirty.Pos = start;
+	b->Dirty.Size = Vec2iMinus(end, start);
+}
+
+static void SetTile(
+	EditorBrush *b, Mission *m, Vec2i pos, unsigned short tile)
 {
 	if (MissionTrySetTile(m, pos, tile))
 	{
 		MapSetTile(&gMap, pos, tile, m);
+		EditorBrushMarkDirty(b, pos);
+		const int idx = pos.y * m->Size.x + pos.x;
+		CArrayPushBack(&b->ChangedTiles, &idx);
 	}
 }
 
@@ -223,7 +245,7 @@ static void EditorBrushPaintTilesAt(void *data, Vec2i pos)
 	{
 		for (v.x = 0; v.x < b->BrushSize; v.x++)
 		{
-			SetTile(m, Vec2iAdd(pos, v), b->PaintType);
+			SetTile(b, m, Vec2iAdd(pos, v), b->PaintType);
 		}
 	}
 }
@@ -263,7 +285,7 @@ static void EditorBrushPaintRoom(EditorBrush *b, Mission *m)
 			const unsigned short tileExisting = IMapGet(&gMap, pos);
 			if (tileExisting != MAP_ROOM)
 			{
-				SetTile(m, pos, tile);
+				SetTile(b, m, pos, tile);
 			}
 		}
 	}
@@ -272,12 +294,19 @@ static void EditorBrushPaintRoom(EditorBrush *b, Mission *m)
 }
 typedef struct
 {
+	EditorBrush *b;
 	Mission *m;
 	unsigned short fromType;
 	unsigned short toType;
 } PaintFloodFillData;
 static void MissionFillTile(void *data, Vec2i v);
 static bool MissionIsTileSame(void *data, Vec2i v);
+static const MapObject *GetStaticItemAt(const Mission *m, const Vec2i pos);
+static bool CanUpdateLiveItem(const MapObject *mo);
+static void RemoveLiveItem(
+	EditorBrush *b, const MapObject *mo, const Vec2i pos);
+static void AddLiveItem(EditorBrush *b, const MapObject *mo, const Vec2i pos);
+static void AddChangedDoorTiles(EditorBrush *b, Mission *m);
 EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 {
 	if (!b->IsPainting)
@@ -331,7 +360,9 @@ EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 			FloodFillData data;
 			data.Fill = MissionFillTile;
 			data.IsSame = MissionIsTileSame;
+			data.Size = m->Size;
 			PaintFloodFillData pData;
+			pData.b = b;
 			pData.m = m;
 			pData.fromType = MissionGetTile(m, b->Pos) & MAP_MASKACCESS;
 			pData.toType = b->PaintType;
@@ -346,23 +377,45 @@ EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 		if (MissionGetTile(m, b->Pos) == MAP_ROOM ||
 			MissionGetTile(m, b->Pos) == MAP_FLOOR)
 		{
+			if (!Vec2iIsZero(m->u.Static.Start))
+			{
+				EditorBrushMarkDirty(b, m->u.Static.Start);
+			}
+			EditorBrushMarkDirty(b, b->Pos);
 			m->u.Static.Start = b->Pos;
 			return EDITOR_RESULT_CHANGED;
 		}
 		break;
 	case BRUSHTYPE_ADD_ITEM:
-		if (isMain)
+		// Items are updated in the live map directly, without reloading,
+		// where possible
 		{
-			if (MissionStaticTryAddItem(m, b->u.MapObject, b->Pos))
+			const MapObject *old = GetStaticItemAt(m, b->Pos);
+			if (isMain)
 			{
-				return EDITOR_RESULT_CHANGED_AND_RELOAD;
+				if (MissionStaticTryAddItem(m, b->u.MapObject, b->Pos))
+				{
+					if (!CanUpdateLiveItem(old) ||
+						!CanUpdateLiveItem(b->u.MapObject))
+					{
+						return EDITOR_RESULT_CHANGED_AND_RELOAD;
+					}
+					RemoveLiveItem(b, old, b->Pos);
+					AddLiveItem(b, b->u.MapObject, b->Pos);
+					return EDITOR_RESULT_CHANGED;
+				}
 			}
-		}
-		else
-		{
-			if (MissionStaticTryRemoveItemAt(m, b->Pos))
+			else
 			{
-				return EDITOR_RESULT_CHANGED_AND_RELOAD;
+				if (MissionStaticTryRemoveItemAt(m, b->Pos))
+				{
+					if (!CanUpdateLiveItem(old))
+					{
+						return EDITOR_RESULT_CHANGED_AND_RELOAD;
+					}
+					RemoveLiveItem(b, old, b->Pos);
+					return EDITOR_RESULT_CHANGED;
+				}
 			}
 		}
 		break;
@@ -420,6 +473,7 @@ EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 		{
 			if (MissionStaticTrySetKey(m, b->u.ItemIndex, b->Pos))
 			{
+				AddChangedDoorTiles(b, m);
 				return EDITOR_RESULT_CHANGED_AND_RELOAD;
 			}
 		}
@@ -427,6 +481,7 @@ EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 		{
 			if (MissionStaticTryUnsetKeyAt(m, b->Pos))
 			{
+				AddChangedDoorTiles(b, m);
 				return EDITOR_RESULT_CHANGED_AND_RELOAD;
 			}
 		}
@@ -438,10 +493,71 @@ EditorResult EditorBrushStartPainting(EditorBrush *b, Mission *m, int isMain)
 	b->IsPainting = 1;
 	return EDITOR_RESULT_NONE;
 }
+static const MapObject *GetStaticItemAt(const Mission *m, const Vec2i pos)
+{
+	CA_FOREACH(const MapObjectPositions, mop, m->u.Static.Items)
+		for (int i = 0; i < (int)mop->Positions.size; i++)
+		{
+			if (Vec2iEqual(*(const Vec2i *)CArrayGet(&mop->Positions, i), pos))
+			{
+				return mop->M;
+			}
+		}
+	CA_FOREACH_END()
+	return NULL;
+}
+// Pickup spawners create pickups of their own, which are not tracked here;
+// reload the map for those instead
+static bool CanUpdateLiveItem(const MapObject *mo)
+{
+	return mo == NULL || mo->Type != MAP_OBJECT_TYPE_PICKUP_SPAWNER;
+}
+// Remove the live map object placed for a static item
+// Objects are placed with an offset, and on-wall objects are placed in the
+// tile above, so find the object by its class and exact position
+static void RemoveLiveItem(
+	EditorBrush *b, const MapObject *mo, const Vec2i pos)
+{
+	if (mo == NULL)
+	{
+		return;
+	}
+	const Vec2i realPos = MapObjectGetPlacementPos(mo, pos);
+	if (!MapIsRealPosIn(&gMap, realPos))
+	{
+		return;
+	}
+	const Vec2i tilePos = Vec2iToTile(realPos);
+	Tile *t = MapGetTile(&gMap, tilePos);
+	TILE_FOREACH_THING(t, ti)
+		if (ti->kind != KIND_OBJECT || ti->x != realPos.x || ti->y != realPos.y)
+		{
+			continue;
+		}
+		TObject *o = CArrayGet(&gObjs, ti->id);
+		if (o->Class == mo && !(ti->flags & TILEITEM_OBJECTIVE))
+		{
+			ObjDestroy(o);
+			break;
+		}
+	TILE_FOREACH_THING_END()
+	EditorBrushMarkDirty(b, pos);
+	EditorBrushMarkDirty(b, tilePos);
+}
+static void AddLiveItem(EditorBrush *b, const MapObject *mo, const Vec2i pos)
+{
+	MapTryPlaceOneObject(&gMap, pos, mo, 0, false);
+	EditorBrushMarkDirty(b, pos);
+	const Vec2i realPos = MapObjectGetPlacementPos(mo, pos);
+	if (MapIsRealPosIn(&gMap, realPos))
+	{
+		EditorBrushMarkDirty(b, Vec2iToTile(realPos));
+	}
+}
 static void MissionFillTile(void *data, Vec2i v)
 {
 	PaintFloodFillData *pData = data;
-	SetTile(pData->m, v, pData->toType);
+	SetTile(pData->b, pData->m, v, pData->toType);
 }
 static bool MissionIsTileSame(void *data, Vec2i v)
 {
@@ -546,6 +662,7 @@ EditorResult EditorBrushStopPainting(EditorBrush *b, Mission *m)
 							&m->u.Static.Tiles, idx);
 						CArrayPushBack(&movedTiles, tile);
 						*tile = MAP_FLOOR;
+						CArrayPushBack(&b->ChangedTiles, &idx);
 					}
 				}
 				// Move the selection to the new position
@@ -568,6 +685,7 @@ EditorResult EditorBrushStopPainting(EditorBrush *b, Mission *m)
 							unsigned short *tileTo = CArrayGet(
 								&m->u.Static.Tiles, idx);
 							*tileTo = *tileFrom;
+							CArrayPushBack(&b->ChangedTiles, &idx);
 							result = EDITOR_RESULT_CHANGED_AND_RELOAD;
 						}
 						i++;
@@ -651,3 +769,43 @@ EditorResult EditorBrushStopPainting(EditorBrush *b, Mission *m)
 	CArrayClear(&b->HighlightedTiles);
 	return result;
 }
+// Setting a key fills the connected door tiles without going through
+// SetTile; record the whole door so the change can be undone
+static void AddChangedDoorTiles(EditorBrush *b, Mission *m)
+{
+	const int start = (int)b->ChangedTiles.size;
+	int idx = b->Pos.y * m->Size.x + b->Pos.x;
+	CArrayPushBack(&b->ChangedTiles, &idx);
+	// Doors are only a few tiles; search the added ones for duplicates
+	for (int i = start; i < (int)b->ChangedTiles.size; i++)
+	{
+		const int cur = *(int *)CArrayGet(&b->ChangedTiles, i);
+		const Vec2i pos = Vec2iNew(cur % m->Size.x, cur / m->Size.x);
+		const Vec2i dirs[] =
+		{
+			Vec2iNew(-1, 0), Vec2iNew(1, 0), Vec2iNew(0, -1), Vec2iNew(0, 1)
+		};
+		for (int j = 0; j < 4; j++)
+		{
+			const Vec2i v = Vec2iAdd(pos, dirs[j]);
+			if ((MissionGetTile(m, v) & MAP_MASKACCESS) != MAP_DOOR)
+			{
+				continue;
+			}
+			idx = v.y * m->Size.x + v.x;
+			bool found = false;
+			for (int k = start; k < (int)b->ChangedTiles.size; k++)
+			{
+				if (*(int *)CArrayGet(&b->ChangedTiles, k) == idx)
+				{
+					found = true;
+					break;
+				}
+			}
+			if (!found)
+			{
+				CArrayPushBack(&b->ChangedTiles, &idx);
+			}
+		}
+	}
+}
@@ -88,6 +88,10 @@ typedef struct
 	Vec2i SelectionSize;
 	int IsMoving;	// for the select tool, whether selecting or moving
 	Vec2i DragPos;	// when moving, location that the drag started
+	// Map tiles changed since the last redraw; zero size if none
+	Rect2i Dirty;
+	// Indices of mission tiles changed since the last undo commit
+	CArray ChangedTiles;	// of int
 
 	char GuideImage[CDOGS_PATH_MAX];
 	bool IsGuideImageNew;
@@ -99,6 +103,7 @@ void EditorBrushInit(EditorBrush *b);
 void EditorBrushTerminate(EditorBrush *b);
 
 void EditorBrushSetHighlightedTiles(EditorBrush *b);
+void EditorBrushMarkDirty(EditorBrush *b, const Vec2i pos);
 typedef enum
 {
 	EDITOR_RESULT_NONE,
@@ -0,0 +1,350 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "editor_undo.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <cdogs/map.h>
+#include <cdogs/map_build.h>
+
+
+static void EntryTerminate(EditorUndoEntry *e);
+
+void EditorUndoInit(EditorUndo *u, const size_t budget)
+{
+	memset(u, 0, sizeof *u);
+	CArrayInit(&u->Entries, sizeof(EditorUndoEntry));
+	u->Budget = budget;
+	u->MissionIndex = -1;
+}
+void EditorUndoTerminate(EditorUndo *u)
+{
+	CA_FOREACH(EditorUndoEntry, e, u->Entries)
+		EntryTerminate(e);
+	CA_FOREACH_END()
+	CArrayTerminate(&u->Entries);
+	MissionTerminate(&u->Last);
+}
+
+void EditorUndoReset(
+	EditorUndo *u, const Mission *m,
+	const int missionIndex, const int numMissions)
+{
+	CA_FOREACH(EditorUndoEntry, e, u->Entries)
+		EntryTerminate(e);
+	CA_FOREACH_END()
+	CArrayClear(&u->Entries);
+	u->Index = 0;
+	u->Size = 0;
+	MissionTerminate(&u->Last);
+	if (m != NULL)
+	{
+		MissionCopy(&u->Last, m);
+	}
+	u->MissionIndex = missionIndex;
+	u->NumMissions = numMissions;
+}
+
+bool EditorUndoIsMission(
+	const EditorUndo *u, const int missionIndex, const int numMissions)
+{
+	return u->MissionIndex == missionIndex && u->NumMissions == numMissions;
+}
+
+static void AddTileRuns(
+	EditorUndoEntry *e, Mission *last, const Mission *m,
+	CArray *changedTiles);
+static void MissionCopyRest(Mission *dst, const Mission *src);
+static void SwapRest(Mission *a, Mission *b);
+static size_t EntryGetSize(const EditorUndoEntry *e);
+static void RemoveEntry(EditorUndo *u, const int idx);
+void EditorUndoCommit(
+	EditorUndo *u, const Mission *m, CArray *changedTiles,
+	const bool changedRest)
+{
+	EditorUndoEntry e;
+	memset(&e, 0, sizeof e);
+	CArrayInit(&e.Runs, sizeof(EditorUndoRun));
+	CArrayInit(&e.Tiles, sizeof(unsigned short));
+	if (m->Type != u->Last.Type || !Vec2iEqual(m->Size, u->Last.Size))
+	{
+		// The map was resized or converted, which changes all the tiles
+		// anyway; keep the whole previous mission
+		CMALLOC(e.Rest, sizeof *e.Rest);
+		*e.Rest = u->Last;
+		e.IsWhole = true;
+		memset(&u->Last, 0, sizeof u->Last);
+		MissionCopy(&u->Last, m);
+	}
+	else
+	{
+		if (m->Type == MAPTYPE_STATIC)
+		{
+			AddTileRuns(&e, &u->Last, m, changedTiles);
+		}
+		if (changedRest)
+		{
+			// Last takes the new state, and the entry the old one
+			CMALLOC(e.Rest, sizeof *e.Rest);
+			memset(e.Rest, 0, sizeof *e.Rest);
+			MissionCopyRest(e.Rest, m);
+			SwapRest(&u->Last, e.Rest);
+		}
+	}
+	CArrayClear(changedTiles);
+	if (e.Runs.size == 0 && e.Rest == NULL)
+	{
+		EntryTerminate(&e);
+		return;
+	}
+	e.Size = EntryGetSize(&e);
+
+	// A new edit loses the redo history
+	while ((int)u->Entries.size > u->Index)
+	{
+		RemoveEntry(u, (int)u->Entries.size - 1);
+	}
+	CArrayPushBack(&u->Entries, &e);
+	u->Index++;
+	u->Size += e.Size;
+
+	// Forget the oldest edits to stay within budget, but keep the newest
+	while (u->Size > u->Budget && u->Entries.size > 1)
+	{
+		RemoveEntry(u, 0);
+		u->Index--;
+	}
+}
+static int CompareInt(const void *v1, const void *v2);
+static void AddTileRuns(
+	EditorUndoEntry *e, Mission *last, const Mission *m,
+	CArray *changedTiles)
+{
+	// Strokes touch tiles many times; sort so that each tile is visited
+	// once and neighbours join into runs
+	qsort(
+		changedTiles->data, changedTiles->size, changedTiles->elemSize,
+		CompareInt);
+	int prev = -1;
+	CA_FOREACH(const int, idx, *changedTiles)
+		if (*idx == prev)
+		{
+			continue;
+		}
+		prev = *idx;
+		unsigned short *lastTile = CArrayGet(&last->u.Static.Tiles, *idx);
+		const unsigned short tile =
+			*(const unsigned short *)CArrayGet(&m->u.Static.Tiles, *idx);
+		if (*lastTile == tile)
+		{
+			continue;
+		}
+		EditorUndoRun *run = NULL;
+		if (e->Runs.size > 0)
+		{
+			run = CArrayGet(&e->Runs, e->Runs.size - 1);
+		}
+		if (run == NULL || run->Start + run->Count != *idx)
+		{
+			EditorUndoRun r;
+			r.Start = *idx;
+			r.Count = 0;
+			CArrayPushBack(&e->Runs, &r);
+			run = CArrayGet(&e->Runs, e->Runs.size - 1);
+		}
+		run->Count++;
+		if ((*lastTile ^ tile) & MAP_ACCESSBITS)
+		{
+			e->NeedsReload = true;
+		}
+		CArrayPushBack(&e->Tiles, lastTile);
+		*lastTile = tile;
+	CA_FOREACH_END()
+}
+static int CompareInt(const void *v1, const void *v2)
+{
+	const int i1 = *(const int *)v1;
+	const int i2 = *(const int *)v2;
+	if (i1 < i2)
+	{
+		return -1;
+	}
+	else if (i1 > i2)
+	{
+		return 1;
+	}
+	return 0;
+}
+static void MissionCopyRest(Mission *dst, const Mission *src)
+{
+	Mission m = *src;
+	if (m.Type == MAPTYPE_STATIC)
+	{
+		// Leave out the tiles; they are kept as runs
+		CArrayInit(&m.u.Static.Tiles, sizeof(unsigned short));
+	}
+	MissionCopy(dst, &m);
+}
+// Swap everything but the static tiles; both missions must be the same type
+static void SwapRest(Mission *a, Mission *b)
+{
+	const Mission m = *a;
+	*a = *b;
+	*b = m;
+	if (a->Type == MAPTYPE_STATIC)
+	{
+		const CArray tiles = a->u.Static.Tiles;
+		a->u.Static.Tiles = b->u.Static.Tiles;
+		b->u.Static.Tiles = tiles;
+	}
+}
+static size_t ArrayGetSize(const CArray *a)
+{
+	return a->size * a->elemSize;
+}
+static size_t MissionGetSize(const Mission *m)
+{
+	size_t size = sizeof *m +
+		ArrayGetSize(&m->Objectives) +
+		ArrayGetSize(&m->Enemies) +
+		ArrayGetSize(&m->SpecialChars) +
+		ArrayGetSize(&m->MapObjectDensities) +
+		ArrayGetSize(&m->Weapons);
+	if (m->Type == MAPTYPE_STATIC)
+	{
+		size += ArrayGetSize(&m->u.Static.Tiles);
+		CA_FOREACH(const MapObjectPositions, mop, m->u.Static.Items)
+			size += sizeof *mop + ArrayGetSize(&mop->Positions);
+		CA_FOREACH_END()
+		CA_FOREACH(const CharacterPositions, cp, m->u.Static.Characters)
+			size += sizeof *cp + ArrayGetSize(&cp->Positions);
+		CA_FOREACH_END()
+		CA_FOREACH(const ObjectivePositions, op, m->u.Static.Objectives)
+			size += sizeof *op +
+				ArrayGetSize(&op->Positions) + ArrayGetSize(&op->Indices);
+		CA_FOREACH_END()
+		CA_FOREACH(const KeyPositions, kp, m->u.Static.Keys)
+			size += sizeof *kp + ArrayGetSize(&kp->Positions);
+		CA_FOREACH_END()
+	}
+	return size;
+}
+static size_t EntryGetSize(const EditorUndoEntry *e)
+{
+	size_t size = sizeof *e + ArrayGetSize(&e->Runs) + ArrayGetSize(&e->Tiles);
+	if (e->Rest != NULL)
+	{
+		size += MissionGetSize(e->Rest);
+	}
+	return size;
+}
+static void RemoveEntry(EditorUndo *u, const int idx)
+{
+	EditorUndoEntry *e = CArrayGet(&u->Entries, idx);
+	u->Size -= e->Size;
+	EntryTerminate(e);
+	CArrayDelete(&u->Entries, idx);
+}
+static void EntryTerminate(EditorUndoEntry *e)
+{
+	CArrayTerminate(&e->Runs);
+	CArrayTerminate(&e->Tiles);
+	if (e->Rest != NULL)
+	{
+		MissionTerminate(e->Rest);
+		CFREE(e->Rest);
+	}
+}
+
+static EditorResult Apply(
+	EditorUndo *u, EditorUndoEntry *e, Mission *m, EditorBrush *b);
+EditorResult EditorUndoUndo(EditorUndo *u, Mission *m, EditorBrush *b)
+{
+	if (u->Index == 0)
+	{
+		return EDITOR_RESULT_NONE;
+	}
+	u->Index--;
+	return Apply(u, CArrayGet(&u->Entries, u->Index), m, b);
+}
+EditorResult EditorUndoRedo(EditorUndo *u, Mission *m, EditorBrush *b)
+{
+	if (u->Index >= (int)u->Entries.size)
+	{
+		return EDITOR_RESULT_NONE;
+	}
+	u->Index++;
+	return Apply(u, CArrayGet(&u->Entries, u->Index - 1), m, b);
+}
+// Swap the entry's state with the mission's, keeping Last in step
+static EditorResult Apply(
+	EditorUndo *u, EditorUndoEntry *e, Mission *m, EditorBrush *b)
+{
+	if (e->IsWhole)
+	{
+		const Mission other = *m;
+		*m = *e->Rest;
+		*e->Rest = other;
+		MissionCopy(&u->Last, m);
+		return EDITOR_RESULT_CHANGED_AND_RELOAD;
+	}
+
+	EditorResult result = EDITOR_RESULT_NONE;
+	int i = 0;
+	CA_FOREACH(const EditorUndoRun, run, e->Runs)
+		for (int j = 0; j < run->Count; j++, i++)
+		{
+			const int idx = run->Start + j;
+			unsigned short *tile = CArrayGet(&m->u.Static.Tiles, idx);
+			unsigned short *other = CArrayGet(&e->Tiles, i);
+			const unsigned short t = *tile;
+			*tile = *other;
+			*other = t;
+			*(unsigned short *)CArrayGet(&u->Last.u.Static.Tiles, idx) = *tile;
+			const Vec2i pos = Vec2iNew(idx % m->Size.x, idx / m->Size.x);
+			MapSetTile(&gMap, pos, *tile, m);
+			EditorBrushMarkDirty(b, pos);
+		}
+		result = e->NeedsReload ?
+			EDITOR_RESULT_CHANGED_AND_RELOAD : EDITOR_RESULT_CHANGED;
+	CA_FOREACH_END()
+
+	if (e->Rest != NULL)
+	{
+		SwapRest(m, e->Rest);
+		Mission rest;
+		memset(&rest, 0, sizeof rest);
+		MissionCopyRest(&rest, m);
+		SwapRest(&u->Last, &rest);
+		MissionTerminate(&rest);
+		result = EDITOR_RESULT_CHANGED_AND_RELOAD;
+	}
+	return result;
+}
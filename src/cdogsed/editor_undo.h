@@ -0,0 +1,94 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+
+    Copyright (c) 2017, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <cdogs/c_array.h>
+#include <cdogs/mission.h>
+
+#include "editor_brush.h"
+
+// Undo history for the editor, kept as a journal of deltas
+// Each entry holds the other state of what one edit changed: the previous
+// values of runs of static tiles, and/or everything else in the mission.
+// Undoing or redoing an entry swaps that state with the mission's, so both
+// cost as much as the edit, not the map.
+typedef struct
+{
+	int Start;	// index of the first tile
+	int Count;
+} EditorUndoRun;
+typedef struct
+{
+	CArray Runs;	// of EditorUndoRun
+	CArray Tiles;	// of unsigned short, for all the runs in order
+	// Everything but the static tiles, or NULL if unchanged
+	Mission *Rest;
+	// Whether Rest is the whole mission, for edits that resize or convert
+	// the map
+	bool IsWhole;
+	// Whether any tile's access level changed, which needs the doors and
+	// keys to be rebuilt
+	bool NeedsReload;
+	size_t Size;	// approximate memory use, in bytes
+} EditorUndoEntry;
+typedef struct
+{
+	CArray Entries;	// of EditorUndoEntry
+	int Index;	// entries before this are undoable, the rest redoable
+	size_t Size;
+	size_t Budget;
+	// The mission as of the last commit, for the previous values
+	Mission Last;
+	int MissionIndex;
+	int NumMissions;
+} EditorUndo;
+
+void EditorUndoInit(EditorUndo *u, const size_t budget);
+void EditorUndoTerminate(EditorUndo *u);
+
+// Start a new history for a mission; m can be NULL
+void EditorUndoReset(
+	EditorUndo *u, const Mission *m,
+	const int missionIndex, const int numMissions);
+bool EditorUndoIsMission(
+	const EditorUndo *u, const int missionIndex, const int numMissions);
+
+// Record the edits since the last commit as one entry
+// changedTiles: indices of static tiles that may have changed; cleared
+// changedRest: whether anything but the static tiles may have changed
+void EditorUndoCommit(
+	EditorUndo *u, const Mission *m, CArray *changedTiles,
+	const bool changedRest);
+// Changed tiles are applied to the map and marked on the brush for redraw;
+// if anything else changed, the result asks for a reload
+EditorResult EditorUndoUndo(EditorUndo *u, Mission *m, EditorBrush *b);
+EditorResult EditorUndoRedo(EditorUndo *u, Mission *m, EditorBrush *b);
@@ -54,6 +54,7 @@
 #include <cdogs/actors.h>
 #include <cdogs/ai.h>
 #include <cdogs/ai_coop.h>
+#include <cdogs/ai_index.h>
 #include <cdogs/automap.h>
 #include <cdogs/camera.h>
 #include <cdogs/draw/drawtools.h>
@@ -65,6 +66,7 @@
 #include <cdogs/net_client.h>
 #include <cdogs/net_server.h>
 #include <cdogs/objs.h>
+#include <cdogs/path_cache.h>
 
 
 static void PlayerSpecialCommands(TActor *actor, const int cmd)
@@ -87,7 +89,7 @@ static void PlayerSpecialCommands(TActor *actor, const int cmd)
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_SWITCH_GUN);
 		e.u.ActorSwitchGun.UID = actor->uid;
 		e.u.ActorSwitchGun.GunIdx = (actor->gunIndex + 1) % actor->guns.size;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
@@ -160,12 +162,7 @@ static void RunGameDraw(void *data);
 bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 {
 	// Clear the background
-	DrawRectangle(
-		&gGraphicsDevice, Vec2iZero(), gGraphicsDevice.cachedConfig.Res,
-		colorBlack, 0);
-	SDL_UpdateTexture(
-		gGraphicsDevice.bkg, NULL, gGraphicsDevice.buf,
-		gGraphicsDevice.cachedConfig.Res.x * sizeof(Uint32));
+	GraphicsSetBackground(&gGraphicsDevice, NULL);
 
 	MapLoad(map, m, co);
 
@@ -193,7 +190,7 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 			if (!p->IsLocal) continue;
 			GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
 			e.u.PlayerData = PlayerDataMissionReset(p);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		CA_FOREACH_END()
 		// Process the events to force add the players
 		HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -210,6 +207,9 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 			InitializeBadGuys();
 			CreateEnemies();
 		}
+		// Map objects were only just added; rebuild the pathfinding data
+		// they changed now rather than mid-game
+		PathCacheBuild(&gPathCache);
 	}
 
 	RunGameData data;
@@ -247,7 +247,7 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 
 	NetServerSendGameStartMessages(&gNetServer, NET_SERVER_BCAST);
 	GameEvent start = GameEventNew(GAME_EVENT_GAME_START);
-	GameEventsEnqueue(&gGameEvents, start);
+	GameEventsEnqueue(&gGameEvents, &start);
 
 	data.loop = GameLoopDataNew(
 		&data, RunGameUpdate, &data, RunGameDraw);
@@ -257,6 +257,7 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 	data.loop.InputEverySecondFrame = true;
 	GameLoop(&data.loop);
 	LOG(LM_MAIN, LL_INFO, "Game finished");
+	AIIndexClear(&gAIIndex);
 
 	// Flush events
 	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -281,7 +282,7 @@ static void RunGameInput(void *data)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
 		e.u.MissionEnd.IsQuit = true;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		return;
 	}
 
@@ -370,7 +371,7 @@ static void RunGameInput(void *data)
 			// Already paused; exit
 			GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
 			e.u.MissionEnd.IsQuit = true;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			// Need to unpause to process the quit
 			rData->pausingDevice = INPUT_DEVICE_UNSET;
 			rData->controllerUnplugged = false;
@@ -427,7 +428,7 @@ static GameLoopResult RunGameUpdate(void *data)
 	{
 		GameEvent begin = GameEventNew(GAME_EVENT_GAME_BEGIN);
 		begin.u.GameBegin.MissionTime = gMission.time;
-		GameEventsEnqueue(&gGameEvents, begin);
+		GameEventsEnqueue(&gGameEvents, &begin);
 	}
 
 	// Set mission complete and display exit if it is complete
@@ -451,6 +452,8 @@ static GameLoopResult RunGameUpdate(void *data)
 	// Update all the things in the game
 	const int ticksPerFrame = 1;
 
+	AIIndexUpdate(&gAIIndex, rData->map);
+
 	if (gPlayerDatas.size > 0)
 	{
 		LOSReset(&gMap.LOS);
@@ -530,7 +533,7 @@ static GameLoopResult RunGameUpdate(void *data)
 				ei.u.ActorImpulse.UID = p->uid;
 				ei.u.ActorImpulse.Vel = Vec2i2Net(Vec2iScale(vel, 64));
 				ei.u.ActorImpulse.Pos = Vec2i2Net(Vec2iZero());
-				GameEventsEnqueue(&gGameEvents, ei);
+				GameEventsEnqueue(&gGameEvents, &ei);
 				LOG(LM_MAIN, LL_TRACE,
 					"playerUID(%d) pos(%d, %d) screen(%d, %d) impulse(%d, %d)",
 					p->uid, p->tileItem.x, p->tileItem.y, screen.x, screen.y,
@@ -583,7 +586,7 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 			GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
 			e.u.ObjectiveUpdate.ObjectiveId = _ca_index;
 			e.u.ObjectiveUpdate.Count = update;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	CA_FOREACH_END()
 
@@ -592,18 +595,18 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 	if (mo->state == MISSION_STATE_PLAY && isMissionComplete)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_PICKUP);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (mo->state == MISSION_STATE_PICKUP && !isMissionComplete)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_INCOMPLETE);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (mo->state == MISSION_STATE_PICKUP &&
 		mo->pickupTime + PICKUP_LIMIT <= mo->time)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	// Check that all players have been destroyed
@@ -624,7 +627,7 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
 			e.u.MissionEnd.Delay = GAME_OVER_DELAY;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -0,0 +1,156 @@
+#include <cbehave/cbehave.h>
+
+#include <algorithms.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+#define GRID_SIZE 256
+typedef struct
+{
+	char Tiles[GRID_SIZE][GRID_SIZE];
+	int FillCount;
+} Grid;
+static void GridFill(void *data, Vec2i v)
+{
+	Grid *g = data;
+	g->Tiles[v.y][v.x] = 'x';
+	g->FillCount++;
+}
+static bool GridIsSame(void *data, Vec2i v)
+{
+	Grid *g = data;
+	return g->Tiles[v.y][v.x] == '.';
+}
+static bool GridIsSameNoFill(void *data, Vec2i v)
+{
+	Grid *g = data;
+	return g->Tiles[v.y][v.x] != '#';
+}
+static void GridInit(Grid *g, FloodFillData *data)
+{
+	memset(g->Tiles, '.', sizeof g->Tiles);
+	g->FillCount = 0;
+	data->Fill = GridFill;
+	data->IsSame = GridIsSame;
+	data->Size = Vec2iNew(GRID_SIZE, GRID_SIZE);
+	data->data = g;
+}
+static int GridCount(const Grid *g, const char c)
+{
+	int count = 0;
+	for (int y = 0; y < GRID_SIZE; y++)
+	{
+		for (int x = 0; x < GRID_SIZE; x++)
+		{
+			if (g->Tiles[y][x] == c)
+			{
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+FEATURE(CFloodFill, "Flood fill")
+	SCENARIO("Fill a large open area")
+		GIVEN("a large empty grid")
+			static Grid g;
+			FloodFillData data;
+			GridInit(&g, &data);
+
+		WHEN("I flood fill from the middle")
+			const bool filled =
+				CFloodFill(Vec2iNew(GRID_SIZE / 2, GRID_SIZE / 2), &data);
+
+		THEN("every tile should be filled exactly once")
+			SHOULD_BE_TRUE(filled);
+			SHOULD_INT_EQUAL(GridCount(&g, 'x'), GRID_SIZE * GRID_SIZE);
+			SHOULD_INT_EQUAL(g.FillCount, GRID_SIZE * GRID_SIZE);
+	SCENARIO_END
+
+	SCENARIO("Fill an enclosed area")
+		GIVEN("a grid with a walled room")
+			static Grid g;
+			FloodFillData data;
+			GridInit(&g, &data);
+			for (int i = 10; i <= 20; i++)
+			{
+				g.Tiles[10][i] = g.Tiles[20][i] = '#';
+				g.Tiles[i][10] = g.Tiles[i][20] = '#';
+			}
+
+		WHEN("I flood fill inside the room")
+			CFloodFill(Vec2iNew(15, 15), &data);
+
+		THEN("only the inside of the room should be filled")
+			SHOULD_INT_EQUAL(GridCount(&g, 'x'), 9 * 9);
+			SHOULD_INT_EQUAL(g.Tiles[9][15], '.');
+			SHOULD_INT_EQUAL(g.Tiles[21][15], '.');
+	SCENARIO_END
+
+	SCENARIO("Fill around obstacles")
+		GIVEN("a grid with a comb-shaped wall")
+			static Grid g;
+			FloodFillData data;
+			GridInit(&g, &data);
+			for (int x = 0; x < GRID_SIZE; x += 2)
+			{
+				for (int y = 0; y < GRID_SIZE - 1; y++)
+				{
+					g.Tiles[x % 4 == 0 ? y : y + 1][x] = '#';
+				}
+			}
+			const int floors = GridCount(&g, '.');
+
+		WHEN("I flood fill from a corner")
+			CFloodFill(Vec2iNew(1, 0), &data);
+
+		THEN("all the connected tiles should be filled")
+			SHOULD_INT_EQUAL(GridCount(&g, 'x'), floors);
+			SHOULD_INT_EQUAL(g.FillCount, floors);
+	SCENARIO_END
+
+	SCENARIO("Fill starting on a different tile")
+		GIVEN("a grid")
+			static Grid g;
+			FloodFillData data;
+			GridInit(&g, &data);
+			g.Tiles[5][5] = '#';
+
+		WHEN("I flood fill from a tile that is not the same")
+			const bool filled = CFloodFill(Vec2iNew(5, 5), &data);
+
+		THEN("nothing should be filled")
+			SHOULD_BE_FALSE(filled);
+			SHOULD_INT_EQUAL(g.FillCount, 0);
+	SCENARIO_END
+
+	SCENARIO("Fill where filling does not change tiles")
+		GIVEN("a grid where filled tiles still count as the same")
+			static Grid g;
+			FloodFillData data;
+			GridInit(&g, &data);
+			data.IsSame = GridIsSameNoFill;
+
+		WHEN("I flood fill")
+			CFloodFill(Vec2iNew(0, 0), &data);
+
+		THEN("each tile should be filled only once")
+			SHOULD_INT_EQUAL(g.FillCount, GRID_SIZE * GRID_SIZE);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Algorithms features are:",
+	TEST_FEATURE(CFloodFill)
+)
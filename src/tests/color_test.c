@@ -3,6 +3,7 @@
 #include <color.h>
 
 #include <float.h>
+#include <string.h>
 
 
 FEATURE(ColorMult, "Multiply")
@@ -195,6 +196,41 @@ FEATURE(ColorTint, "Tint")
 		THEN("the result should be the same as the original color")
 			SHOULD_MEM_EQUAL(&result, &c, sizeof result);
 	SCENARIO_END
+
+	SCENARIO("Tint with a lookup table")
+		GIVEN("some tints")
+			const HSV tints[] =
+			{
+				{ -1.0, 1.0, 1.0 }, { 0.0, 1.0, 1.0 }, { 120.0, 0.33, 2.0 },
+				{ -1.0, 0.0, 1.0 }, { 300.0, 1.0, 1.0 }, { -1.0, 1.0, 0.75 },
+				{ -1.0, 0.5, 1.5 }, { 359.0, 0.25, 0.5 }
+			};
+
+		WHEN("I tint colors using tables for those tints")
+			int mismatches = 0;
+			for (int i = 0; i < (int)(sizeof tints / sizeof tints[0]); i++)
+			{
+				ColorTintTable t;
+				ColorTintTableInit(&t, tints[i]);
+				for (int j = 0; j < 4096; j++)
+				{
+					const color_t c =
+					{
+						(uint8_t)(j * 37), (uint8_t)(j * 101),
+						(uint8_t)(j * 211), (uint8_t)j
+					};
+					const color_t expected = ColorTint(c, tints[i]);
+					const color_t result = ColorTintTableApply(&t, c);
+					if (memcmp(&expected, &result, sizeof result) != 0)
+					{
+						mismatches++;
+					}
+				}
+			}
+
+		THEN("the results should be the same as tinting directly")
+			SHOULD_INT_EQUAL(mismatches, 0);
+	SCENARIO_END
 FEATURE_END
 
 FEATURE(StrColor, "String conversion")
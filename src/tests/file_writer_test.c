@@ -0,0 +1,127 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <file_writer.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+static void ReadFile(const char *filename, char *buf, const size_t size)
+{
+	memset(buf, 0, size);
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL)
+	{
+		return;
+	}
+	const size_t rc = fread(buf, 1, size - 1, f);
+	UNUSED(rc);
+	fclose(f);
+}
+static char *NewData(const char *s)
+{
+	char *data;
+	CMALLOC(data, strlen(s));
+	memcpy(data, s, strlen(s));
+	return data;
+}
+
+
+FEATURE(save_and_flush, "Save and flush")
+	SCENARIO("Save in the background")
+		GIVEN("a started file writer")
+			FileWriter fw;
+			FileWriterInit(&fw);
+
+		WHEN("I save some data and flush the writer")
+			FileWriterSave(&fw, "tmp", NewData("hello"), strlen("hello"));
+			FileWriterFlush(&fw);
+
+		THEN("the file should have the data")
+			char buf[256];
+			ReadFile("tmp", buf, sizeof buf);
+			SHOULD_STR_EQUAL(buf, "hello");
+		AND("the temporary file should be gone")
+			FILE *f = fopen("tmp.tmp", "rb");
+			SHOULD_BE_TRUE(f == NULL);
+			if (f != NULL) fclose(f);
+			FileWriterTerminate(&fw);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(save_failed, "Failed saves")
+	SCENARIO("Save to a directory that does not exist")
+		GIVEN("a started file writer")
+			FileWriter fw;
+			FileWriterInit(&fw);
+
+		WHEN("I save to a missing directory and flush the writer")
+			FileWriterSave(
+				&fw, "no_such_dir/tmp", NewData("hello"), strlen("hello"));
+			const bool ok = FileWriterFlush(&fw);
+
+		THEN("the flush should report the failure")
+			SHOULD_BE_FALSE(ok);
+		AND("the next flush should not report it again")
+			SHOULD_BE_TRUE(FileWriterFlush(&fw));
+			FileWriterTerminate(&fw);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(save_repeated, "Repeated saves")
+	SCENARIO("Save the same file many times")
+		GIVEN("a started file writer")
+			FileWriter fw;
+			FileWriterInit(&fw);
+
+		WHEN("I save a file many times and stop the writer")
+			char s[32];
+			for (int i = 0; i < 100; i++)
+			{
+				sprintf(s, "save %d", i);
+				FileWriterSave(&fw, "tmp", NewData(s), strlen(s));
+			}
+			FileWriterTerminate(&fw);
+
+		THEN("the file should have the last save")
+			char buf[256];
+			ReadFile("tmp", buf, sizeof buf);
+			SHOULD_STR_EQUAL(buf, "save 99");
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(save_json, "Save JSON")
+	SCENARIO("Save a JSON tree without starting the writer")
+		GIVEN("a file writer that has not been started")
+			FileWriter fw;
+			memset(&fw, 0, sizeof fw);
+		AND("a JSON tree")
+			json_t *root = json_new_object();
+			json_insert_pair_into_object(root, "A", json_new_number("1"));
+
+		WHEN("I save the tree")
+			FileWriterSaveJSON(&fw, "tmp", root);
+
+		THEN("the file should already have the tree")
+			char buf[256];
+			ReadFile("tmp", buf, sizeof buf);
+			SHOULD_BE_TRUE(strstr(buf, "\"A\"") != NULL);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"File writer features are:",
+	TEST_FEATURE(save_and_flush),
+	TEST_FEATURE(save_failed),
+	TEST_FEATURE(save_repeated),
+	TEST_FEATURE(save_json)
+)
@@ -0,0 +1,130 @@
+#include <cbehave/cbehave.h>
+
+#include <path_cache.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+static Vec2i sBlocked = { -1, -1 };
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+bool IsTileWalkable(Map *map, const Vec2i pos)
+{
+	UNUSED(map);
+	return !Vec2iEqual(pos, sBlocked);
+}
+bool IsTileWalkableAroundObjects(Map *map, const Vec2i pos)
+{
+	return IsTileWalkable(map, pos);
+}
+void PathChunksInit(PathChunks *pc, Map *m)
+{
+	UNUSED(pc);
+	UNUSED(m);
+}
+void PathChunksTerminate(PathChunks *pc)
+{
+	UNUSED(pc);
+}
+void PathChunksUpdate(PathChunks *pc)
+{
+	UNUSED(pc);
+}
+void PathChunksInvalidateTile(PathChunks *pc, const Vec2i tile)
+{
+	UNUSED(pc);
+	UNUSED(tile);
+}
+void PathChunksInvalidateKeys(PathChunks *pc, const int keyFlags)
+{
+	UNUSED(pc);
+	UNUSED(keyFlags);
+}
+void FlowFieldsInit(FlowFields *ff, Map *m)
+{
+	UNUSED(ff);
+	UNUSED(m);
+}
+void FlowFieldsTerminate(FlowFields *ff)
+{
+	UNUSED(ff);
+}
+void FlowFieldsInvalidate(FlowFields *ff)
+{
+	UNUSED(ff);
+}
+
+
+FEATURE(PathCacheTerminate, "Path cache terminate")
+	SCENARIO("Terminate a cache that was never initialised")
+		GIVEN("a zero-initialised path cache")
+			PathCache pc;
+			memset(&pc, 0, sizeof pc);
+		WHEN("I terminate it")
+			PathCacheTerminate(&pc);
+		THEN("nothing should be freed and the cache should stay empty")
+			SHOULD_INT_EQUAL((int)pc.size, 0);
+			SHOULD_INT_EQUAL((int)pc.entries.size, 0);
+	SCENARIO_END
+	SCENARIO("Terminate the global cache before any map load")
+		GIVEN("the global path cache")
+		WHEN("I terminate it")
+			PathCacheTerminate(&gPathCache);
+		AND("terminate it again")
+			PathCacheTerminate(&gPathCache);
+		THEN("the cache should stay empty")
+			SHOULD_INT_EQUAL((int)gPathCache.size, 0);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(PathCacheInvalidateTile, "Path cache tile invalidation")
+	SCENARIO("Block a tile whose corner is cut by a cached path")
+		GIVEN("an open map")
+			Map m;
+			memset(&m, 0, sizeof m);
+			m.Size = Vec2iNew(4, 4);
+			PathCache pc;
+			PathCacheInit(&pc, &m);
+		AND("a cached diagonal path")
+			CachedPath cp = PathCacheCreate(
+				&pc, Vec2iNew(0, 0), Vec2iNew(1, 1), false, true);
+			CachedPathDestroy(&cp);
+		WHEN("I block a tile next to, but not on, the path")
+			sBlocked = Vec2iNew(1, 0);
+			PathCacheInvalidateTile(&pc, sBlocked);
+		THEN("the cached path should be removed")
+			SHOULD_INT_EQUAL((int)pc.size, 0);
+		PathCacheTerminate(&pc);
+		sBlocked = Vec2iNew(-1, -1);
+	SCENARIO_END
+	SCENARIO("Block a tile away from a cached path")
+		GIVEN("an open map")
+			Map m;
+			memset(&m, 0, sizeof m);
+			m.Size = Vec2iNew(4, 4);
+			PathCache pc;
+			PathCacheInit(&pc, &m);
+		AND("a cached diagonal path")
+			CachedPath cp = PathCacheCreate(
+				&pc, Vec2iNew(0, 0), Vec2iNew(1, 1), false, true);
+			CachedPathDestroy(&cp);
+		WHEN("I block a tile two tiles away from the path")
+			sBlocked = Vec2iNew(3, 3);
+			PathCacheInvalidateTile(&pc, sBlocked);
+		THEN("the cached path should be kept")
+			SHOULD_BE_TRUE(pc.size > 0);
+		PathCacheTerminate(&pc);
+		sBlocked = Vec2iNew(-1, -1);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Path cache features are:",
+	TEST_FEATURE(PathCacheTerminate),
+	TEST_FEATURE(PathCacheInvalidateTile))
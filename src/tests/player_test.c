@@ -24,6 +24,9 @@ void ActorDestroy(TActor *a)
 {
 	UNUSED(a);
 }
+void ActorsRefreshPlayerCharacters(void)
+{
+}
 void CharacterSetColors(Character *c)
 {
 	UNUSED(c);